@@ -1,5 +1,6 @@
 #include "Actor.h"
 #include "StudentWorld.h"
+#include "Profiler.h"
 
 // Students:  Add code to this file, Actor.h, StudentWorld.h, and StudentWorld.cpp
 
@@ -8,7 +9,14 @@ using namespace std;
 // Actor implementation
 
 // Actor constructor passes neccessary info to GraphObject and initializes m_isDead to false (actors always start out alive) and m_world to point to the associated StudentWorld
-Actor::Actor(int imgID, int x, int y, Direction dir, int depth, StudentWorld* worldPtr) : GraphObject(imgID, x, y, dir, depth), m_isDead(false), m_world(worldPtr) {}
+Actor::Actor(int imgID, int x, int y, Direction dir, int depth, StudentWorld* worldPtr) : GraphObject(imgID, x, y, dir, depth), m_isDead(false), m_world(worldPtr), m_seq(0), m_gridCell(-1), m_timer(-1) {}
+
+// Actor moveTo moves like any GraphObject, then lets the world re-file it in its grid
+void Actor::moveTo(double x, double y)
+{
+    GraphObject::moveTo(x, y);
+    m_world->actorMoved(this);
+}
 
 // Actor -> HP Implementation
 
@@ -35,7 +43,7 @@ bool HP::damage(int hp)
 // Actor -> HP -> Socrates Implementation
 
 // Socrates constructo passes the spec's specified starting point and direction to HP along with correct image ID and world pointer
-Socrates::Socrates(StudentWorld* worldPtr) : HP(IID_PLAYER, 100, 0, VIEW_HEIGHT/2, 0, worldPtr)
+Socrates::Socrates(StudentWorld* worldPtr) : HP(IID_PLAYER, 100, dish().centerX() - dish().radius, dish().centerY(), 0, worldPtr)
 {
     m_sprayCharges = 20; // Set new Socrates spray count to default 20
     m_flameCharges = 5; // Set new Socrates flame count to default 5
@@ -45,6 +53,7 @@ Socrates::Socrates(StudentWorld* worldPtr) : HP(IID_PLAYER, 100, 0, VIEW_HEIGHT/
 // Socrates does something every tick
 void Socrates::doSomething()
 {
+    PROFILE_SCOPE("Socrates::doSomething");
     if (getHP() <= 0) // If no HP kill Socrates and return
     {
         setDead();
@@ -52,7 +61,7 @@ void Socrates::doSomething()
     }
     
     int ch;
-    if (getWorld()->getKey(ch)) // Get keystroke
+    if (getWorld()->getPlayerCommand(ch)) // Get keystroke (or the auto player's choice)
     {
         switch (ch) {
             // For keystrokes corresponding to a socrates movement (left, right, a, d)
@@ -100,7 +109,7 @@ void Socrates::rotate(int key)
         return;
     
     int x, y; // Declare temp vars to store new position
-    polarToCartesian(VIEW_WIDTH/2, VIEW_HEIGHT/2, VIEW_WIDTH/2, m_posAngle, x, y); // Convert new posAngle to cartesian along dish edge
+    polarToCartesian(dish().centerX(), dish().centerY(), dish().radius, m_posAngle, x, y); // Convert new posAngle to cartesian along dish edge
     moveTo(x, y); // Move Socrates
     setDirection(m_posAngle+180); // Update direction facing
 }
@@ -110,10 +119,20 @@ void Socrates::fireFlame()
 {
     int x, y; // Declare temp vars to store flame coords
     Direction theta = getDirection(); // Get direction Socrates is facing
+    if (gameOptions().flameBursts) // The whole ring as one actor
+    {
+        getWorld()->addActor(new FlameBurst(getX(), getY(), theta, getWorld()));
+        m_flameCharges--; // Decrement flame charges
+        getWorld()->playSound(SOUND_PLAYER_FIRE); // Play flame sound
+        return;
+    }
     for (int i = 0; i < 16; i++) // Loop for 16 flames
     {
         polarToCartesian(getX(), getY(), 2*SPRITE_RADIUS, theta, x, y); // Get cartesian coords 2*SPRITE_RADIUS away from socrates in specified direction
-        getWorld()->addActor(new Flame(x, y, theta, getWorld())); // Add flame
+        if (gameOptions().sweptProjectiles) // Swept flames live in the world's projectile system
+            getWorld()->addProjectile(IID_FLAME, x, y, theta, 32, 5); // Same max distance and damage as Flame
+        else
+            getWorld()->addActor(new Flame(x, y, theta, getWorld())); // Add flame
         theta += 22; // increment around socrates in a circle by 22 deg
     }
     m_flameCharges--; // Decrement flame charges
@@ -124,7 +143,10 @@ void Socrates::fireSpray()
 {
     int x, y; // Temp vars to store spray coords
     polarToCartesian(getX(), getY(), 2*SPRITE_RADIUS, getDirection(), x, y); // Get cartesian coords 2*SPRITE_RADIUS in front of Socrates
-    getWorld()->addActor(new Spray(x, y, getDirection(), getWorld())); // Add spray to world
+    if (gameOptions().sweptProjectiles) // Swept sprays live in the world's projectile system
+        getWorld()->addProjectile(IID_SPRAY, x, y, getDirection(), 112, 2); // Same max distance and damage as Spray
+    else
+        getWorld()->addActor(new Spray(x, y, getDirection(), getWorld())); // Add spray to world
     m_sprayCharges--; // Decrement spray charges
     getWorld()->playSound(SOUND_PLAYER_SPRAY); // Play spray sound
 }
@@ -136,11 +158,13 @@ Bacteria::Bacteria(int imgID, int hp, int x, int y, StudentWorld* worldPtr) : HP
 {
     m_mvmtPlanDist = 0; // Set default movement plan to 0
     m_foodEaten = 0; // Set default food eaten to 0
+    m_sector = -1; // Not counted in any sector until the world adds it
 }
 
 // Bacteria method for doing something each tick
 void Bacteria::doSomething()
 {
+    PROFILE_SCOPE("Bacteria::doSomething");
     if (isDead() || getHP() <= 0) // Check if it is dead
     {
         setDead(); // Set to dead and return
@@ -158,15 +182,15 @@ void Bacteria::doSomething()
         int newY = getY();
         
         // Calculate newX according to spec
-        if (getX() < VIEW_WIDTH/2)
+        if (getX() < dish().centerX())
             newX = getX() + SPRITE_RADIUS;
-        else if (getX() > VIEW_WIDTH/2)
+        else if (getX() > dish().centerX())
             newX = getX() - SPRITE_RADIUS;
         
         // Calculate newY according to spec
-        if (getY() < VIEW_HEIGHT/2)
+        if (getY() < dish().centerY())
             newY = getY() + SPRITE_RADIUS;
-        else if (getY() > VIEW_HEIGHT/2)
+        else if (getY() > dish().centerY())
             newY = getY() - SPRITE_RADIUS;
         
         divideBacteria(newX, newY); // Divide correct bacteria type using new coords
@@ -283,7 +307,7 @@ void Salmonella::plannedMove()
 void Salmonella::backupMove()
 {
     int angleToNearestFood;
-    if (getWorld()->getAngleToNearestFood(this, 128, angleToNearestFood)) // Attempt getting angle to food within 128 distance
+    if (getWorld()->getAngleToNearestFood(this, FOOD_RANGE, angleToNearestFood)) // Attempt getting angle to food within 128 distance
     {
         setDirection(angleToNearestFood);
         
@@ -358,35 +382,48 @@ void AggSalmonella::damageSocrates()
     getWorld()->damagePlayer(2);
 }
 
-// Actor -> Dirt implementation
-
-// Dirt method to recieve damage
-bool Dirt::damage(int)
-{
-    // Dirt instantly dies no matter how much damage is caused
-    setDead();
-    return true; // Return true for can be damaged
-}
-
 // Actor -> Food implementation
 // Food has no out-of-line implementation (just a placeholder)
 
 // Actor -> (Bacteria) Pit implementation
 
-// Pit method to do something each tick
+// Pit Constructor passes to Actor correct img ID, direction 0, depth 1, and initializes the bacteria storage counters to specifications
+Pit::Pit(int x, int y, StudentWorld* worldPtr) : Actor(IID_PIT, x, y, 0, 1, worldPtr), m_regSalm(5), m_aggSalm(3), m_EColi(2)
+{
+    setStatic(true); // Pits never move, so they can be drawn with the static layer
+    if (gameOptions().sampledEvents) // Draw when the first emission happens
+        scheduleNextEmission();
+}
+
+// Pit method to do something each tick (or, with sampled events, on the ticks it is woken)
 void Pit::doSomething()
 {
+    PROFILE_SCOPE("Pit::doSomething");
     if (m_regSalm == 0 && m_aggSalm == 0 && m_EColi == 0) // Check if it ran out of bacteria, and setDead if true
     {
         setDead();
         return;
     }
+    else if (gameOptions().sampledEvents) // Woken on the tick its 1/50 chance comes up
+    {
+        emitBacteria();
+        scheduleNextEmission();
+    }
     else if (randInt(0, 49) == 0) // otherwise 1/50 chance to emit a bacteria using emitBacteria
     {
         emitBacteria();
     }
 }
 
+// Pit method to schedule its next turn with sampled events
+void Pit::scheduleNextEmission()
+{
+    if (m_regSalm == 0 && m_aggSalm == 0 && m_EColi == 0) // Empty, so wake next tick to die (as it would when acting every tick)
+        getWorld()->wakeAt(this, getWorld()->currentTick() + 1);
+    else // Otherwise sleep until its 1/50 per tick chance next comes up
+        getWorld()->wakeAt(this, getWorld()->currentTick() + randTicksUntil(50));
+}
+
 // Pit method to emit a bacteria
 void Pit::emitBacteria()
 {
@@ -427,12 +464,15 @@ void Pit::emitBacteria()
 // Item constructor that passes necessary info to Actor with direction 0 and depth 1
 Item::Item(int imgID, int x, int y, StudentWorld* worldPtr) : Actor(imgID, x, y, 0, 1, worldPtr)
 {
-    m_lifetime = max(rand()%(300-10*(getWorld()->getLevel())), 50); // Set lifetime to spec's random function
+    int lifetime = max(rand()%(300-10*(getWorld()->getLevel())), 50); // Get lifetime from spec's random function
+    m_expiryTick = getWorld()->currentTick() + lifetime; // It counts down once per tick starting next tick
+    getWorld()->wakeAt(this, m_expiryTick); // Sleep until then (the world also wakes it if it overlaps Socrates)
 }
 
-// Item method to do something every tick
+// Item method to do something on ticks the world wakes it (touching Socrates or expiring)
 void Item::doSomething()
 {
+    PROFILE_SCOPE("Item::doSomething");
     if (isDead()) // Check if it is dead, return if it is
         return;
     else if (getWorld()->overlapsPlayer(this)) // Check if it overlaps the player
@@ -444,8 +484,7 @@ void Item::doSomething()
         return;
     }
     // Otherwise
-    m_lifetime--; // Decrement lifetime
-    if (m_lifetime <= 0) // Check if lifetime is over and set it to dead if it is
+    if (getWorld()->currentTick() >= m_expiryTick) // Check if lifetime is over and set it to dead if it is
         setDead();
     return;
 }
@@ -515,6 +554,7 @@ Projectile::Projectile(int imgID, int x, int y, Direction dir, int maxDist, Stud
 // Projectile method to do something each tick
 void Projectile::doSomething()
 {
+    PROFILE_SCOPE("Projectile::doSomething");
     if (isDead()) // Check if it is dead and return if true
         return;
     if (attemptDamage()) // Attempt damage specific to projectile type
@@ -549,3 +589,61 @@ bool Spray::attemptDamage()
 {
     return getWorld()->damageNearbyActor(this, 2);
 }
+
+// Actor -> FlameBurst Implementation
+
+// FlameBurst constructor places the flames exactly where fireFlame places its Flames
+FlameBurst::FlameBurst(int x, int y, Direction dir, StudentWorld* worldPtr) : Actor(IID_FLAME, x, y, dir, 1, worldPtr), m_sprites(IID_FLAME, 0, 1), m_maxDist(32)
+{
+    setVisible(false); // Only the flames are drawn
+    Direction theta = dir;
+    for (int i = 0; i < N_FLAMES; i++)
+    {
+        int fx, fy;
+        polarToCartesian(x, y, 2*SPRITE_RADIUS, theta, fx, fy); // Same coords as a Flame
+        m_flameX[i] = fx;
+        m_flameY[i] = fy;
+        m_flameDir[i] = theta; // Keep the unnormalized angle, as a Flame's GraphObject does
+        m_flameAlive[i] = true;
+        m_sprites.add(fx, fy, theta);
+        theta += FLAME_SPACING;
+    }
+}
+
+// FlameBurst method to do something each tick (each flame does what Projectile::doSomething does, in ring order)
+void FlameBurst::doSomething()
+{
+    PROFILE_SCOPE("FlameBurst::doSomething");
+    if (isDead()) // Check if it is dead and return if true
+        return;
+    // One query for the whole ring (out to the farthest flame plus overlap distance, with a pixel to spare)
+    double reach = 0;
+    for (int i = 0; i < N_FLAMES; i++)
+        if (m_flameAlive[i])
+            reach = max(reach, sqrt(pow(m_flameX[i] - getX(), 2.0) + pow(m_flameY[i] - getY(), 2.0)));
+    getWorld()->beginAreaDamage(getX(), getY(), reach + 2*SPRITE_RADIUS + 1);
+    m_maxDist -= 2*SPRITE_RADIUS;
+    m_sprites.clear();
+    bool anyAlive = false;
+    for (int i = 0; i < N_FLAMES; i++)
+    {
+        if (!m_flameAlive[i])
+            continue;
+        if (getWorld()->damageInArea(m_flameX[i], m_flameY[i], 5)) // Same damage as Flame
+        {
+            m_flameAlive[i] = false; // Flame is used up by the hit
+            continue;
+        }
+        // Otherwise move forward 2*SPRITE_RADIUS (same arithmetic as getPositionInThisDirection)
+        advanceCoords(m_flameX[i], m_flameY[i], m_flameDir[i], 2*SPRITE_RADIUS);
+        if (m_maxDist <= 0) // Out of distance
+        {
+            m_flameAlive[i] = false;
+            continue;
+        }
+        m_sprites.add(m_flameX[i], m_flameY[i], m_flameDir[i]);
+        anyAlive = true;
+    }
+    if (!anyAlive)
+        setDead();
+}
@@ -17,13 +17,23 @@ public:
     // Member functions
     bool isDead() const {return m_isDead;}
     void setDead() {m_isDead = true;}
+    unsigned long getSeq() const {return m_seq;} // Order actor was added to world (world's actor vector is kept in this order)
+    void setSeq(unsigned long seq) {m_seq = seq;}
+    int getGridCell() const {return m_gridCell;} // World's ActorGrid cell holding this actor (-1 if not in grid)
+    void setGridCell(int cell) {m_gridCell = cell;}
+    int getTimer() const {return m_timer;} // World's TimerWheel id for this actor's next wake-up (-1 if none)
+    void setTimer(int id) {m_timer = id;}
+    // Virtual functions (from base class)
+    virtual void moveTo(double x, double y); // Redefine so the world can keep its ActorGrid up to date
     // Pure Virtual functions
     virtual void doSomething() = 0; // Function for each actor to implement action during each tick
     // Virtual functions
     virtual bool damage(int) {return false;} // Function to recieve damage (if possible) to this actor (also returns whether actor can be damaged or not)
     virtual bool isEdible() const {return false;} // Returns whether bacteria can eat this actor
-    virtual bool blocksBacteria() const {return false;} // Returns whether it blocks bacteria mvmt (defaults to false)
+    virtual bool isBacteria() const {return false;} // Returns whether this actor is a bacterium (defaults to false)
     virtual bool preventsLevelCompletion() const {return false;} // Returns whether this actor prevents level completion (defaults to false)
+    virtual bool isDormant() const {return false;} // Returns whether this actor only acts on ticks the world wakes it (defaults to false)
+    virtual bool wakesOnPlayerContact() const {return false;} // Returns whether the world also wakes this dormant actor on ticks it overlaps Socrates (defaults to false)
     // Destructor
     virtual ~Actor() {}
     
@@ -33,10 +43,15 @@ protected:
     
 private:
     // Data members
-    bool m_isDead; // Data member to track live/dead state
+    bool m_isDead; // Data member to track live/dead state (first, so it packs into the end of GraphObject)
     StudentWorld* m_world; // Ptr to associated world
+    unsigned long m_seq; // Order added to world
+    int m_gridCell; // Current grid cell
+    int m_timer; // Pending wake-up timer
 };
 
+static_assert(sizeof(Actor) <= 64, "An Actor should fit in one 64-byte cache line (56 bytes with KONTAGION_FIXED_POINT)");
+
 // Actor -> HP Class
 // HP class represents Actors that have HP (Socrates/Bacteria)
 
@@ -108,6 +123,11 @@ public:
     // Virtual Functions
     virtual void doSomething();
     virtual bool preventsLevelCompletion() const {return true;} // Redefine function because live bacteria prevents level completion
+    virtual bool isBacteria() const {return true;} // Redefine since this is a bacterium
+    // Member Functions
+    int getPlanDist() const {return m_mvmtPlanDist;} // Moves left in its movement plan (0 means its next move is a backup move)
+    int getSector() const {return m_sector;} // Rim sector the world last counted it in (-1 if none)
+    void setSector(int sector) {m_sector = sector;}
     // Destructor
     virtual ~Bacteria() {}
     
@@ -126,6 +146,7 @@ protected:
 private:
     // Data members
     int m_mvmtPlanDist; // Track mvmt plan distance
+    int m_sector; // Rim sector it's counted in (GameOptions::autoPlay)
     int m_foodEaten; // Track food eaten
 };
 
@@ -161,6 +182,8 @@ public:
     Salmonella(int hp, int x, int y, StudentWorld* worldPtr) : Bacteria(IID_SALMONELLA, hp, x, y, worldPtr) {}
     // Destructor
     virtual ~Salmonella() {}
+    // Constants
+    static const int FOOD_RANGE = 128; // Distance a salmonella looks for food in when it has no movement plan
     
 protected:
     // Virtual Functions
@@ -205,22 +228,6 @@ protected:
     virtual void damageSocrates(); // Damage socrates correctly for aggressive salmonella
 };
 
-// Actor -> Dirt Class
-// Dirt class represents Dirt actor that blocks bacteria
-
-class Dirt: public Actor
-{
-public:
-    // Constructor correct img ID, direction 0, and depth 1 to Actor
-    Dirt(int x, int y, StudentWorld* worldPtr) : Actor(IID_DIRT, x, y, 0, 1, worldPtr) {}
-    // Virtual functions
-    virtual void doSomething() {} // Do nothing
-    virtual bool damage(int); // Redefine damage since dirt can be damaged
-    virtual bool blocksBacteria() const {return true;} // Redefine since dirt block bacteria mvmt
-    // Destructor
-    virtual ~Dirt() {}
-};
-
 // Actor -> Food Class
 // Food class represents Food actor that can be eaten by bacteria
 
@@ -232,6 +239,7 @@ public:
     // Virtual functions
     virtual void doSomething() {} // Do nothing
     virtual bool isEdible() const {return true;} // Redefine since Food is edible
+    virtual bool isDormant() const {return true;} // Redefine since Food never does anything
     // Destructor
     virtual ~Food() {}
 };
@@ -243,18 +251,22 @@ class Pit: public Actor
 {
 public:
     // Constructor passes to Actor correct img ID, direction 0, depth 1, and initializes the bacteria storage counters to specifications
-    Pit(int x, int y, StudentWorld* worldPtr) : Actor(IID_PIT, x, y, 0, 1, worldPtr), m_regSalm(5), m_aggSalm(3), m_EColi(2) {}
+    Pit(int x, int y, StudentWorld* worldPtr);
     // Virtual functions
     virtual void doSomething();
     virtual bool preventsLevelCompletion() const {return true;}
+    virtual bool isDormant() const {return gameOptions().sampledEvents;} // With sampled events a pit only acts on the ticks it emits
     // Destructor
     virtual ~Pit() {}
+    // Constants
+    static const int N_BACTERIA = 10; // Bacteria a pit holds (and emits) in all, the sum of the counters below
     
 private:
     // Data members
     int m_regSalm, m_aggSalm, m_EColi; // Track how many stored bacteria pit has
     // Private Member functions
     void emitBacteria(); // Method to emit a random stored bacteria
+    void scheduleNextEmission(); // Method to have the world wake the pit when it next emits (sampled events)
 };
 
 // Actor -> Item ABSTRACT Class
@@ -268,6 +280,8 @@ public:
     // Virtual functions
     virtual void doSomething();
     virtual bool damage(int); // Goodies can be damaged
+    virtual bool isDormant() const {return true;} // Redefine since goodies only act when Socrates touches them or they expire
+    virtual bool wakesOnPlayerContact() const {return true;} // Redefine since Socrates picks goodies up by touching them
     // Destructor
     virtual ~Item() {}
     
@@ -278,7 +292,7 @@ protected:
     
 private:
     // Data members
-    int m_lifetime; // Track goodie lifetime
+    unsigned long m_expiryTick; // Tick the goodie disappears on (the world wakes it then)
 };
 
 // Actor -> Item -> Restore Health Goodie Class
@@ -393,4 +407,31 @@ protected:
     virtual bool attemptDamage(); // Redefine for spray's damage amount
 };
 
+// Actor -> FlameBurst Class
+// FlameBurst is a whole flame charge (GameOptions::flameBursts): the ring of 16 flames as one actor.
+// Each tick it asks the world for everything near the ring once, then moves each flame exactly like a Flame would,
+// so it hits the same things in the same order. The actor itself is invisible; the flames are drawn as a SpriteBatch.
+
+class FlameBurst: public Actor
+{
+public:
+    // Constructor sets up the ring around (x,y) (Socrates), the first flame facing dir
+    FlameBurst(int x, int y, Direction dir, StudentWorld* worldPtr);
+    // Virtual Functions
+    virtual void doSomething();
+    // Destructor
+    virtual ~FlameBurst() {}
+    
+private:
+    // Constants
+    static const int N_FLAMES = 16; // Same ring as fireFlame
+    static const int FLAME_SPACING = 22; // Degrees between flames
+    // Data members
+    GraphObject::SpriteBatch m_sprites; // The flames still alive
+    Coord m_flameX[N_FLAMES], m_flameY[N_FLAMES]; // Flame positions
+    Direction m_flameDir[N_FLAMES]; // Flame directions
+    bool m_flameAlive[N_FLAMES]; // Whether each flame is still going
+    int m_maxDist; // Distance left for every flame (Flame's maxDist)
+};
+
 #endif // ACTOR_H_
@@ -0,0 +1,111 @@
+#ifndef ACTORGRID_H_
+#define ACTORGRID_H_
+
+#include "Actor.h"
+#include <cmath>
+#include <vector>
+
+//////////
+// ActorGrid class declaration
+//////////
+
+// Uniform grid of square cells over the dish, each listing the actors whose center is in it.
+// Neighbor queries only look at the cells a query circle touches instead of every actor.
+// Actors outside the dish (e.g. projectiles flying off the rim) are kept in the nearest edge cell.
+
+class ActorGrid
+{
+public:
+    ActorGrid() : m_cellSize(MIN_CELL_SIZE), m_cols(0), m_rows(0) {}
+    void reset(int width, int height); // Empty the grid and size it to cover a width x height dish
+    void insert(Actor* a); // Add actor to the cell for its position
+    void remove(Actor* a); // Remove actor from its cell
+    void update(Actor* a); // Move actor to a new cell if its position changed cells
+    template<typename Func>
+    void forEachNear(double x, double y, double radius, Func f) const; // Call f(Actor*) for every actor in a cell within radius of (x,y) (callers still check exact distance)
+
+private:
+    static const int MIN_CELL_SIZE = 16; // Two sprite diameters, so overlap queries touch at most 4 cells
+    static const int MAX_CELLS_PER_SIDE = 1024; // Cells grow past MIN_CELL_SIZE in very large dishes to bound memory
+    int m_cellSize; // Cell side length in pixels
+    int m_cols, m_rows; // Grid dimensions in cells
+    std::vector<std::vector<Actor*>> m_cells; // Actors in each cell (row major)
+    int clampedCol(double x) const; // Column containing x, clamped into the grid
+    int clampedRow(double y) const; // Row containing y, clamped into the grid
+    int cellOf(double x, double y) const {return clampedRow(y) * m_cols + clampedCol(x);}
+};
+
+//////////
+// ActorGrid inline implementation
+//////////
+
+inline void ActorGrid::reset(int width, int height)
+{
+    m_cellSize = MIN_CELL_SIZE;
+    while (width / m_cellSize > MAX_CELLS_PER_SIDE || height / m_cellSize > MAX_CELLS_PER_SIDE)
+        m_cellSize *= 2;
+    m_cols = width / m_cellSize + 1;
+    m_rows = height / m_cellSize + 1;
+    m_cells.assign(m_cols * m_rows, std::vector<Actor*>());
+}
+
+inline void ActorGrid::insert(Actor* a)
+{
+    int cell = cellOf(a->getX(), a->getY());
+    m_cells[cell].push_back(a);
+    a->setGridCell(cell);
+}
+
+inline void ActorGrid::remove(Actor* a)
+{
+    int cell = a->getGridCell();
+    if (cell < 0)
+        return;
+    std::vector<Actor*>& actors = m_cells[cell];
+    for (size_t i = 0; i < actors.size(); i++)
+    {
+        if (actors[i] == a)
+        {
+            actors[i] = actors.back(); // Order within a cell doesn't matter, so swap and pop
+            actors.pop_back();
+            break;
+        }
+    }
+    a->setGridCell(-1);
+}
+
+inline void ActorGrid::update(Actor* a)
+{
+    if (a->getGridCell() < 0) // Not in the grid (e.g. Socrates)
+        return;
+    if (cellOf(a->getX(), a->getY()) != a->getGridCell())
+    {
+        remove(a);
+        insert(a);
+    }
+}
+
+template<typename Func>
+void ActorGrid::forEachNear(double x, double y, double radius, Func f) const
+{
+    int c0 = clampedCol(x - radius), c1 = clampedCol(x + radius);
+    int r0 = clampedRow(y - radius), r1 = clampedRow(y + radius);
+    for (int r = r0; r <= r1; r++)
+        for (int c = c0; c <= c1; c++)
+            for (Actor* a : m_cells[r * m_cols + c])
+                f(a);
+}
+
+inline int ActorGrid::clampedCol(double x) const
+{
+    int c = static_cast<int>(std::floor(x / m_cellSize));
+    return c < 0 ? 0 : (c >= m_cols ? m_cols - 1 : c);
+}
+
+inline int ActorGrid::clampedRow(double y) const
+{
+    int r = static_cast<int>(std::floor(y / m_cellSize));
+    return r < 0 ? 0 : (r >= m_rows ? m_rows - 1 : r);
+}
+
+#endif // ACTORGRID_H_
@@ -0,0 +1,128 @@
+#ifndef ACTORLEDGER_H_
+#define ACTORLEDGER_H_
+
+#include "Actor.h"
+#include <cstddef>
+#include <iomanip>
+#include <ostream>
+#include <typeinfo>
+#include <vector>
+
+//////////
+// ActorLedger class declaration
+//////////
+
+// Memory accounting for the actors in a world, by concrete Actor subclass.
+// Each live actor is charged its object size plus one node of the GraphObject registry (std::set) it sits in.
+// Heap memory an actor owns beyond that (e.g. a FlameBurst's SpriteBatch) isn't counted.
+// Current and peak counts and bytes are kept per type and in total; peaks cover everything since resetPeaks.
+
+class ActorLedger
+{
+public:
+    struct TypeStats
+    {
+        const char* name; // Class name
+        size_t bytesEach; // Object size plus registry node
+        long count, peakCount; // Live actors of this type now, and at most
+        size_t bytes, peakBytes; // Bytes they use now, and at most
+    };
+    ActorLedger() : m_count(0), m_peakCount(0), m_bytes(0), m_peakBytes(0) {}
+    template<typename T>
+    void addType(const char* name); // Register concrete type T (actors of unregistered types are charged as a bare Actor)
+    void add(const Actor* a); // Charge a newly added actor
+    void remove(const Actor* a); // Credit an actor about to be deleted
+    void resetPeaks(); // Start new peaks from the current values
+    long count() const {return m_count;} // Live actors now
+    long peakCount() const {return m_peakCount;}
+    size_t bytes() const {return m_bytes;} // Bytes live actors use now
+    size_t peakBytes() const {return m_peakBytes;} // Most bytes used at once
+    const std::vector<TypeStats>& types() const {return m_types;} // Per-type values, in registration order
+    void report(std::ostream& out) const; // Print a table of every type with actors now or at peak
+
+private:
+    struct TypeEntry {const std::type_info* type; size_t index;};
+    std::vector<TypeEntry> m_entries; // Registered types, with their index in m_types
+    std::vector<TypeStats> m_types; // Values by type (the last is for unregistered types once one shows up)
+    long m_count, m_peakCount;
+    size_t m_bytes, m_peakBytes;
+    TypeStats& statsFor(const Actor* a); // Stats for a's concrete type
+};
+
+//////////
+// ActorLedger inline implementation
+//////////
+
+template<typename T>
+void ActorLedger::addType(const char* name)
+{
+    m_entries.push_back(TypeEntry{&typeid(T), m_types.size()});
+    m_types.push_back(TypeStats{name, sizeof(T) + GraphObject::REGISTRY_NODE_BYTES, 0, 0, 0, 0});
+}
+
+inline ActorLedger::TypeStats& ActorLedger::statsFor(const Actor* a)
+{
+    const std::type_info& type = typeid(*a);
+    for (const TypeEntry& e : m_entries)
+    {
+        if (*e.type == type)
+            return m_types[e.index];
+    }
+    if (m_types.size() == m_entries.size()) // First unregistered actor
+        m_types.push_back(TypeStats{"(unregistered)", sizeof(Actor) + GraphObject::REGISTRY_NODE_BYTES, 0, 0, 0, 0});
+    return m_types.back();
+}
+
+inline void ActorLedger::add(const Actor* a)
+{
+    TypeStats& s = statsFor(a);
+    s.count++;
+    s.bytes += s.bytesEach;
+    if (s.count > s.peakCount)
+        s.peakCount = s.count;
+    if (s.bytes > s.peakBytes)
+        s.peakBytes = s.bytes;
+    m_count++;
+    m_bytes += s.bytesEach;
+    if (m_count > m_peakCount)
+        m_peakCount = m_count;
+    if (m_bytes > m_peakBytes)
+        m_peakBytes = m_bytes;
+}
+
+inline void ActorLedger::remove(const Actor* a)
+{
+    TypeStats& s = statsFor(a);
+    s.count--;
+    s.bytes -= s.bytesEach;
+    m_count--;
+    m_bytes -= s.bytesEach;
+}
+
+inline void ActorLedger::resetPeaks()
+{
+    for (TypeStats& s : m_types)
+    {
+        s.peakCount = s.count;
+        s.peakBytes = s.bytes;
+    }
+    m_peakCount = m_count;
+    m_peakBytes = m_bytes;
+}
+
+inline void ActorLedger::report(std::ostream& out) const
+{
+    out << std::left << std::setw(22) << "actor type" << std::right << std::setw(8) << "bytes"
+        << std::setw(8) << "live" << std::setw(8) << "peak" << std::setw(12) << "live bytes" << std::setw(12) << "peak bytes" << '\n';
+    for (const TypeStats& s : m_types)
+    {
+        if (s.peakCount == 0) // Never seen
+            continue;
+        out << std::left << std::setw(22) << s.name << std::right << std::setw(8) << s.bytesEach
+            << std::setw(8) << s.count << std::setw(8) << s.peakCount << std::setw(12) << s.bytes << std::setw(12) << s.peakBytes << '\n';
+    }
+    out << std::left << std::setw(22) << "total" << std::right << std::setw(8) << ""
+        << std::setw(8) << m_count << std::setw(8) << m_peakCount << std::setw(12) << m_bytes << std::setw(12) << m_peakBytes << '\n';
+}
+
+#endif // ACTORLEDGER_H_
@@ -0,0 +1,88 @@
+#ifndef ASSETLOADER_H_
+#define ASSETLOADER_H_
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+  // Runs a batch of independent loading tasks (reading and decoding asset
+  // files) on a few worker threads, so startup takes about as long as the
+  // slowest file instead of the sum of all of them.  Tasks are started in
+  // the order they were added.  The GLUT thread polls isDone() to pick up
+  // finished work (e.g., to upload a decoded texture) while it keeps drawing.
+
+class AssetLoader
+{
+  public:
+
+    AssetLoader()
+     : m_next(0), m_nDone(0)
+    {
+    }
+
+    ~AssetLoader()
+    {
+        wait();
+    }
+
+      // Add a task; call before start().  Returns the task's number.
+    size_t add(std::function<void()> task)
+    {
+        m_tasks.push_back(std::move(task));
+        return m_tasks.size() - 1;
+    }
+
+    void start()
+    {
+        m_done.reset(new std::atomic<bool>[m_tasks.size()]);
+        for (size_t i = 0; i < m_tasks.size(); i++)
+            m_done[i] = false;
+        size_t nWorkers = std::min<size_t>(m_tasks.size(), std::max(2u, std::thread::hardware_concurrency()));
+        for (size_t w = 0; w < nWorkers; w++)
+            m_workers.emplace_back(&AssetLoader::work, this);
+    }
+
+    bool isDone(size_t task) const
+    {
+        return m_done[task].load(std::memory_order_acquire);
+    }
+
+    bool allDone() const
+    {
+        return m_nDone == m_tasks.size();
+    }
+
+      // Block until every task has finished
+    void wait()
+    {
+        for (std::thread& t : m_workers)
+            t.join();
+        m_workers.clear();
+    }
+
+      // Prevent copying or assigning AssetLoaders
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+  private:
+    std::vector<std::function<void()>>      m_tasks;
+    std::unique_ptr<std::atomic<bool>[]>    m_done;
+    std::atomic<size_t>                     m_next;
+    std::atomic<size_t>                     m_nDone;
+    std::vector<std::thread>                m_workers;
+
+    void work()
+    {
+        for (size_t i = m_next++; i < m_tasks.size(); i = m_next++)
+        {
+            m_tasks[i]();
+            m_done[i].store(true, std::memory_order_release);
+            m_nDone++;
+        }
+    }
+};
+
+#endif // ASSETLOADER_H_
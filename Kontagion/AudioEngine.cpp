@@ -0,0 +1,313 @@
+#include "AudioEngine.h"
+#include "GameConstants.h"
+#include "SoundFX.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+using namespace std;
+
+//////////
+// WAV decoding
+//////////
+
+static uint32_t readLE(const unsigned char* p, int nBytes)
+{
+    uint32_t v = 0;
+    for (int i = nBytes - 1; i >= 0; i--)
+        v = (v << 8) | p[i];
+    return v;
+}
+
+bool decodeWav(const string& path, vector<int16_t>& samples)
+{
+    ifstream wavFile(path, ios::in|ios::binary);
+    if (!wavFile)
+        return false;
+    vector<unsigned char> data((istreambuf_iterator<char>(wavFile)), istreambuf_iterator<char>());
+    if (data.size() < 12  ||  memcmp(&data[0], "RIFF", 4) != 0  ||  memcmp(&data[8], "WAVE", 4) != 0)
+        return false;
+
+    int format = 0, channels = 0, bitsPerSample = 0;
+    uint32_t sampleRate = 0;
+    const unsigned char* pcm = nullptr;
+    size_t pcmBytes = 0;
+    for (size_t pos = 12; pos + 8 <= data.size(); )
+    {
+        const unsigned char* chunk = &data[pos];
+        size_t chunkSize = readLE(chunk + 4, 4);
+        size_t available = min(chunkSize, data.size() - pos - 8);
+        if (memcmp(chunk, "fmt ", 4) == 0  &&  available >= 16)
+        {
+            format = readLE(chunk + 8, 2);
+            channels = readLE(chunk + 10, 2);
+            sampleRate = readLE(chunk + 12, 4);
+            bitsPerSample = readLE(chunk + 22, 2);
+        }
+        else if (memcmp(chunk, "data", 4) == 0)
+        {
+            pcm = chunk + 8;
+            pcmBytes = available;
+        }
+        pos += 8 + chunkSize + (chunkSize & 1);
+    }
+
+    if (format != 1  ||  pcm == nullptr  ||  sampleRate == 0  ||
+        (channels != 1  &&  channels != 2)  ||  (bitsPerSample != 8  &&  bitsPerSample != 16))
+        return false;
+
+      // Convert to 16-bit stereo, then resample linearly to the mix rate
+    int bytesPerSample = bitsPerSample / 8;
+    size_t nFrames = pcmBytes / (bytesPerSample * channels);
+    vector<int16_t> source(nFrames * 2);
+    for (size_t f = 0; f < nFrames; f++)
+    {
+        for (int c = 0; c < 2; c++)
+        {
+            const unsigned char* s = pcm + (f * channels + min(c, channels - 1)) * bytesPerSample;
+            source[2*f + c] = (bytesPerSample == 1 ? int16_t((int(s[0]) - 128) << 8)
+                                                    : int16_t(readLE(s, 2)));
+        }
+    }
+
+    size_t outFrames = size_t(double(nFrames) * AudioSink::SAMPLE_RATE / sampleRate);
+    samples.resize(outFrames * 2);
+    for (size_t f = 0; f < outFrames; f++)
+    {
+        double srcPos = double(f) * sampleRate / AudioSink::SAMPLE_RATE;
+        size_t i = size_t(srcPos);
+        size_t j = min(i + 1, nFrames - 1);
+        double frac = srcPos - i;
+        for (int c = 0; c < 2; c++)
+            samples[2*f + c] = int16_t(source[2*i + c] * (1 - frac) + source[2*j + c] * frac);
+    }
+    return true;
+}
+
+//////////
+// WavFileAudioSink
+//////////
+
+WavFileAudioSink::WavFileAudioSink(const string& fileName)
+ : m_file(fopen(fileName.c_str(), "wb")), m_framesWritten(0)
+{
+    if (m_file != nullptr)
+        writeHeader();
+}
+
+WavFileAudioSink::~WavFileAudioSink()
+{
+    if (m_file != nullptr)
+    {
+          // Now that the length is known, fill it in
+        fseek(m_file, 0, SEEK_SET);
+        writeHeader();
+        fclose(m_file);
+    }
+}
+
+void WavFileAudioSink::write(const int16_t* frames, size_t nFrames)
+{
+    if (m_file == nullptr)
+        return;
+    for (size_t i = 0; i < nFrames * CHANNELS; i++)
+    {
+        unsigned char le[2] = { static_cast<unsigned char>(frames[i] & 0xff),
+                                static_cast<unsigned char>((frames[i] >> 8) & 0xff) };
+        fwrite(le, 1, 2, m_file);
+    }
+    m_framesWritten += static_cast<uint32_t>(nFrames);
+}
+
+void WavFileAudioSink::writeHeader()
+{
+    uint32_t dataBytes = m_framesWritten * CHANNELS * 2;
+    uint32_t fields[] = {
+        36 + dataBytes,                         // RIFF chunk size
+        16,                                     // fmt chunk size
+        1 | (CHANNELS << 16),                   // PCM, channel count
+        SAMPLE_RATE,
+        SAMPLE_RATE * CHANNELS * 2,             // byte rate
+        (CHANNELS * 2) | (16 << 16),            // block align, bits per sample
+        dataBytes
+    };
+    const char* tags[] = { "RIFF", "WAVEfmt ", nullptr, nullptr, nullptr, nullptr, "data" };
+    for (int i = 0; i < 7; i++)
+    {
+        if (tags[i] != nullptr)
+            fwrite(tags[i], 1, strlen(tags[i]), m_file);
+        unsigned char le[4];
+        for (int b = 0; b < 4; b++)
+            le[b] = static_cast<unsigned char>(fields[i] >> (8 * b));
+        fwrite(le, 1, 4, m_file);
+    }
+}
+
+//////////
+// AudioEngine
+//////////
+
+AudioEngine::AudioEngine()
+ : m_backend(SYSTEM_BACKEND), m_voices(), m_tickSounds(0), m_readySounds(0),
+   m_tickStop(false), m_readyStop(false), m_running(false)
+{
+}
+
+AudioEngine::~AudioEngine()
+{
+    stop();
+}
+
+void AudioEngine::setBackend(Backend backend, string wavFileName)
+{
+    m_backend = backend;
+    m_wavFileName = wavFileName;
+}
+
+void AudioEngine::loadClip(int soundID, const string& path)
+{
+    if (soundID < 0  ||  soundID >= MAX_SOUND_IDS)
+        return;
+    Clip& clip = m_clips[soundID];
+    clip.path = path;
+    clip.samples.clear();
+    if (mixing()  &&  !decodeWav(path, clip.samples))
+        clip.samples.clear();   // a missing clip just stays silent, as with SoundFX
+}
+
+void AudioEngine::start()
+{
+    if (m_running)
+        return;
+    if (m_backend == WAV_FILE_BACKEND)
+    {
+        unique_ptr<WavFileAudioSink> sink(new WavFileAudioSink(m_wavFileName));
+        if (!sink->isOpen())
+            cerr << "Cannot write " << m_wavFileName << "; sound will be discarded." << endl;
+        m_sink = move(sink);
+    }
+    else if (m_backend == NULL_BACKEND)
+        m_sink.reset(new NullAudioSink);
+    m_running = true;
+    m_thread = thread(&AudioEngine::run, this);
+}
+
+void AudioEngine::stop()
+{
+    if (!m_thread.joinable())
+        return;
+    m_running = false;
+    m_thread.join();
+    if (!mixing())
+        SoundFX().abortClip();
+    m_sink.reset();     // closes a WAV file
+}
+
+void AudioEngine::play(int soundID)
+{
+    if (soundID == SOUND_NONE)
+    {
+          // Stopping supersedes anything queued earlier in the tick
+        m_tickSounds = 0;
+        m_tickStop = true;
+    }
+    else if (soundID >= 0  &&  soundID < MAX_SOUND_IDS)
+        m_tickSounds.fetch_or(uint64_t(1) << soundID, memory_order_relaxed);
+}
+
+void AudioEngine::commitTick()
+{
+    if (m_tickStop.exchange(false))
+    {
+        m_readySounds = 0;
+        m_readyStop = true;
+    }
+    uint64_t sounds = m_tickSounds.exchange(0, memory_order_relaxed);
+    if (sounds != 0)
+        m_readySounds.fetch_or(sounds, memory_order_release);
+}
+
+void AudioEngine::run()
+{
+    using Clock = chrono::steady_clock;
+    const auto blockDuration = chrono::microseconds(1000000LL * FRAMES_PER_BLOCK / AudioSink::SAMPLE_RATE);
+    vector<int16_t> block(FRAMES_PER_BLOCK * AudioSink::CHANNELS);
+    Clock::time_point nextBlock = Clock::now();
+
+    while (m_running)
+    {
+        bool stopAll = m_readyStop.exchange(false);
+        uint64_t sounds = m_readySounds.exchange(0, memory_order_acquire);
+
+        if (mixing())
+        {
+            if (stopAll)
+            {
+                for (Voice& v : m_voices)
+                    v.clip = nullptr;
+            }
+            for (int id = 0; id < MAX_SOUND_IDS; id++)
+            {
+                if ((sounds >> id) & 1)
+                    startVoice(m_clips[id]);
+            }
+            mixBlock(block.data());
+            m_sink->write(block.data(), FRAMES_PER_BLOCK);
+            nextBlock += blockDuration;
+            this_thread::sleep_until(nextBlock);
+        }
+        else
+        {
+            if (stopAll)
+                SoundFX().abortClip();
+              // The system player handles one clip at a time, as before
+            for (int id = 0; id < MAX_SOUND_IDS; id++)
+            {
+                if (((sounds >> id) & 1)  &&  !m_clips[id].path.empty())
+                    SoundFX().playClip(m_clips[id].path);
+            }
+            this_thread::sleep_for(chrono::milliseconds(2));
+        }
+    }
+}
+
+void AudioEngine::startVoice(const Clip& clip)
+{
+    if (clip.samples.empty())
+        return;
+      // Use a free voice, or else steal the one that has played longest
+    Voice* chosen = &m_voices[0];
+    for (Voice& v : m_voices)
+    {
+        if (v.clip == nullptr)
+        {
+            chosen = &v;
+            break;
+        }
+        if (v.position > chosen->position)
+            chosen = &v;
+    }
+    chosen->clip = &clip;
+    chosen->position = 0;
+}
+
+void AudioEngine::mixBlock(int16_t* out)
+{
+    const size_t nSamples = FRAMES_PER_BLOCK * AudioSink::CHANNELS;
+    int32_t mix[FRAMES_PER_BLOCK * AudioSink::CHANNELS] = {};
+    for (Voice& v : m_voices)
+    {
+        if (v.clip == nullptr)
+            continue;
+        const vector<int16_t>& samples = v.clip->samples;
+        size_t n = min(nSamples, samples.size() - v.position);
+        for (size_t i = 0; i < n; i++)
+            mix[i] += samples[v.position + i];
+        v.position += n;
+        if (v.position >= samples.size())
+            v.clip = nullptr;
+    }
+    for (size_t i = 0; i < nSamples; i++)
+        out[i] = static_cast<int16_t>(max(-32768, min(32767, mix[i])));
+}
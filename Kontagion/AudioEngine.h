@@ -0,0 +1,129 @@
+#ifndef AUDIOENGINE_H_
+#define AUDIOENGINE_H_
+
+#include "GameConstants.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+  // Sound effects are handled on a dedicated audio thread so that playing a
+  // sound from inside a tick is just setting a bit.  play() records the sound
+  // ID for the current tick (so dozens of identical births or deaths in one
+  // tick become one sound), commitTick() hands the tick's sounds to the audio
+  // thread, and the audio thread does the slow part:
+  //
+  //   - with the system backend it launches the platform's SoundFX player,
+  //     as playSound used to do directly;
+  //   - with a mixing backend (null or WAV-file sink) every clip is decoded
+  //     once by loadClips() and the audio thread mixes a bounded pool of
+  //     voices into the sink in real time.  This is what Linux and headless
+  //     test runs use, since SoundFX is silent there.
+
+  // Where mixed audio goes
+class AudioSink
+{
+  public:
+    static const int SAMPLE_RATE = 44100;
+    static const int CHANNELS = 2;
+
+    virtual ~AudioSink() {}
+      // frames holds nFrames interleaved stereo 16-bit samples
+    virtual void write(const int16_t* frames, size_t nFrames) = 0;
+};
+
+  // Discards everything
+class NullAudioSink : public AudioSink
+{
+  public:
+    virtual void write(const int16_t*, size_t) {}
+};
+
+  // Records the mixed stream as a 16-bit stereo WAV file
+class WavFileAudioSink : public AudioSink
+{
+  public:
+    explicit WavFileAudioSink(const std::string& fileName);
+    virtual ~WavFileAudioSink();
+    virtual void write(const int16_t* frames, size_t nFrames);
+    bool isOpen() const { return m_file != nullptr; }
+
+  private:
+    std::FILE*  m_file;
+    uint32_t    m_framesWritten;
+
+    void writeHeader();
+};
+
+class AudioEngine
+{
+  public:
+    enum Backend { SYSTEM_BACKEND, NULL_BACKEND, WAV_FILE_BACKEND };
+
+    AudioEngine();
+    ~AudioEngine();
+
+      // Choose how sounds are played; call before start()
+    void setBackend(Backend backend, std::string wavFileName = "");
+
+      // Register the file to play for a sound ID.  With a mixing backend the
+      // file is decoded now, so nothing is read from disk during play.
+    void loadClip(int soundID, const std::string& path);
+
+    void start();
+    void stop();
+
+      // Queue soundID for the current tick; SOUND_NONE stops all sounds.
+      // Never blocks.
+    void play(int soundID);
+
+      // Release the current tick's sounds to the audio thread
+    void commitTick();
+
+      // Prevent copying or assigning AudioEngines
+    AudioEngine(const AudioEngine&) = delete;
+    AudioEngine& operator=(const AudioEngine&) = delete;
+
+  private:
+    static const int MAX_VOICES = 8;
+    static const int FRAMES_PER_BLOCK = 512;
+
+    struct Clip
+    {
+        std::string          path;
+        std::vector<int16_t> samples;   // interleaved stereo at SAMPLE_RATE
+    };
+
+    struct Voice
+    {
+        const Clip* clip;
+        size_t      position;   // in samples
+    };
+
+    Backend                     m_backend;
+    std::string                 m_wavFileName;
+    std::unique_ptr<AudioSink>  m_sink;
+    Clip                        m_clips[MAX_SOUND_IDS];
+    Voice                       m_voices[MAX_VOICES];
+
+    std::atomic<uint64_t>       m_tickSounds;   // played during the current tick
+    std::atomic<uint64_t>       m_readySounds;  // committed, waiting for the audio thread
+    std::atomic<bool>           m_tickStop;
+    std::atomic<bool>           m_readyStop;
+    std::atomic<bool>           m_running;
+    std::thread                 m_thread;
+
+    bool mixing() const { return m_backend != SYSTEM_BACKEND; }
+    void run();
+    void startVoice(const Clip& clip);
+    void mixBlock(int16_t* out);
+};
+
+  // Decode a PCM WAV file to interleaved stereo 16-bit samples at
+  // AudioSink::SAMPLE_RATE.  Returns false if the file can't be used.
+bool decodeWav(const std::string& path, std::vector<int16_t>& samples);
+
+#endif // AUDIOENGINE_H_
@@ -0,0 +1,55 @@
+#include "AutoPlayer.h"
+#include "StudentWorld.h"
+#include "Actor.h"
+#include "Profiler.h"
+
+//////////
+// AutoPlayer Implementation
+//////////
+
+// AutoPlayer Constructor
+AutoPlayer::AutoPlayer(StudentWorld* world, Socrates* player) : m_world(world), m_player(player)
+{
+}
+
+// AutoPlayer method to pick Socrates' action for this tick
+bool AutoPlayer::getCommand(int &ch)
+{
+    PROFILE_SCOPE("AutoPlayer::getCommand");
+    // Flame when bacteria crowd Socrates
+    if (m_player->getFlames() > 0 && m_world->countBacteriaNear(m_player->getX(), m_player->getY(), FLAME_REACH, CROWD_SIZE) >= CROWD_SIZE)
+    {
+        ch = KEY_PRESS_ENTER;
+        return true;
+    }
+    // Spray when a bacterium is in the lane (any dirt in front of it gets cleared on the way)
+    if (m_world->bacteriaInLane(m_player, m_player->getDirection(), SPRAY_RANGE))
+    {
+        if (m_player->getSprays() == 0) // Out of sprays, so idle to recharge
+            return false;
+        ch = KEY_PRESS_SPACE;
+        return true;
+    }
+    // Otherwise head around the rim toward the nearest bacteria
+    int playerSector = StudentWorld::rimSector(m_player->getX(), m_player->getY()); // Socrates' place around the rim
+    int target = targetSector(playerSector);
+    if (target < 0 || target == playerSector) // Nothing to chase (or it is still out of range), so recharge
+        return false;
+    int ahead = (target - playerSector + StudentWorld::N_RIM_SECTORS) % StudentWorld::N_RIM_SECTORS; // Sectors to go rotating left (increasing angle)
+    ch = (ahead <= StudentWorld::N_RIM_SECTORS / 2) ? KEY_PRESS_LEFT : KEY_PRESS_RIGHT;
+    return true;
+}
+
+// AutoPlayer method to find the sector with bacteria closest to playerSector in either direction
+int AutoPlayer::targetSector(int playerSector) const
+{
+    const int n = StudentWorld::N_RIM_SECTORS;
+    for (int d = 0; d <= n / 2; d++) // At most one pass around the rim, however many bacteria there are
+    {
+        if (m_world->bacteriaInSector((playerSector + d) % n) > 0)
+            return (playerSector + d) % n;
+        if (m_world->bacteriaInSector((playerSector - d + n) % n) > 0)
+            return (playerSector - d + n) % n;
+    }
+    return -1; // No bacteria seen
+}
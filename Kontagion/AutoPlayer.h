@@ -0,0 +1,48 @@
+#ifndef AUTOPLAYER_H_
+#define AUTOPLAYER_H_
+
+class StudentWorld;
+class Socrates;
+
+//////////
+// PlayerController class declaration
+//////////
+
+// Decides what Socrates does each tick, in the same terms as a keystroke.
+// Without one (the default), Socrates is played from the keyboard.
+
+class PlayerController
+{
+public:
+    virtual bool getCommand(int &ch) = 0; // Set ch to the key Socrates should act on, or return false to do nothing this tick
+    virtual ~PlayerController() {}
+};
+
+//////////
+// AutoPlayer class declaration
+//////////
+
+// Plays Socrates from the world state (GameOptions::autoPlay), so headless runs can reach high levels.
+// Each tick it either flames when bacteria crowd Socrates, sprays when a bacterium is in the spray lane,
+// rotates toward the nearest rim sector holding bacteria, or idles so sprays recharge.
+// The world keeps the per-sector bacteria counts as bacteria are added, move, and are deleted,
+// so a tick's work doesn't grow with the population.
+// The counts depend only on which bacteria are alive where, not on how the world stores its actors,
+// so options that change that storage (e.g. --flame-bursts) don't change how it plays.
+
+class AutoPlayer : public PlayerController
+{
+public:
+    AutoPlayer(StudentWorld* world, Socrates* player);
+    virtual bool getCommand(int &ch);
+
+private:
+    static const int SPRAY_RANGE = 112; // Distance a spray travels
+    static const int FLAME_REACH = 48; // Distance from Socrates a flame reaches
+    static const int CROWD_SIZE = 2; // Bacteria within FLAME_REACH worth a flame charge
+    StudentWorld* m_world;
+    Socrates* m_player;
+    int targetSector(int playerSector) const; // Nearest sector to playerSector with bacteria (-1 if none)
+};
+
+#endif // AUTOPLAYER_H_
@@ -0,0 +1,232 @@
+#ifndef BACTERIABATCH_H_
+#define BACTERIABATCH_H_
+
+#include "Actor.h"
+#include <cmath>
+#include <vector>
+
+//////////
+// BacteriaBatch class declaration
+//////////
+
+// Batched first half of the bacteria update (GameOptions::batchedBacteria).
+// Before the actor loop, measure gathers the bacteria into structure-of-arrays state, one group per species,
+// and works out for all of them at once what their turns will ask the world: how far away Socrates is,
+// which food they would eat, and (for salmonella due a backup move) which food they would head for.
+// Food candidates come from a bucket index of the food, rebuilt each pass, in cells Salmonella::FOOD_RANGE wide.
+// Bacteria then still act one at a time, in sequence order, through their per-object doSomething (the reference).
+// The world's queries use a measured answer only for the bacterium now acting, and only while it provably still holds:
+// the bacterium hasn't moved, no food has been added since, and food it would eat hasn't been eaten.
+// Food never moves and dead food stays in the world until the end of the tick, so nothing else can change an answer.
+
+class BacteriaBatch
+{
+public:
+    BacteriaBatch() : m_cellSize(Salmonella::FOOD_RANGE), m_cols(0), m_rows(0), m_foodAdded(0), m_measuredFoodAdded(0),
+                      m_measured(false), m_actingGroup(-1), m_actingIndex(0) {}
+    void reset(int width, int height); // Size the food index to cover a width x height dish and drop any measurements
+    void measure(const std::vector<Actor*>& active, const std::vector<Actor*>& actors, const Actor* player); // Measure the bacteria in active (food is found in actors)
+    void finish() {m_measured = false; m_actingGroup = -1;} // Done with the measurements (until the next measure)
+    void foodAdded() {m_foodAdded++;} // Called whenever food is added to the world
+    void setActing(int i); // The actor at index i of the measured active vector acts now (-1 for anything else)
+    bool playerDistance(const Actor* a, CoordDistance& dist) const; // Distance from a to Socrates (false if no measurement applies)
+    bool foodToEat(const Actor* a, Actor*& food) const; // Earliest-added live food overlapping a, or nullptr (false if no measurement applies)
+    bool foodInRange(const Actor* a, int dist, Actor*& food) const; // Earliest-added food within dist of a, or nullptr (false if no measurement applies)
+
+private:
+    enum Species {ECOLI, SALMONELLA, N_SPECIES}; // Grouped by image: regular and aggressive salmonella look for food alike, E. coli never does
+    struct Group // State of one species' bacteria, by index in the group
+    {
+        std::vector<Actor*> actor;
+        std::vector<Coord> x, y; // Positions when measured
+        std::vector<CoordDistance> playerDist; // Distance to Socrates
+        std::vector<Actor*> eat; // Earliest-added live food overlapping (nullptr if none)
+        std::vector<Actor*> search; // Earliest-added food within FOOD_RANGE (nullptr if none)
+        std::vector<char> searched; // Whether search was measured (only for salmonella due a backup move)
+    };
+    struct Slot {int group, index;}; // Where an active actor's measurements are (group -1 if it has none)
+    Group m_groups[N_SPECIES];
+    std::vector<Slot> m_slots; // Slot of each actor in the measured active vector
+    std::vector<Actor*> m_food; // Every edible actor, in sequence order
+    std::vector<Coord> m_foodX, m_foodY; // Their positions
+    std::vector<char> m_foodLive; // Whether each was alive when measured
+    std::vector<std::vector<int>> m_cells; // Indexes in m_food of the food in each cell (row major, ascending)
+    int m_cellSize; // Cell side length in pixels
+    int m_cols, m_rows; // Food index dimensions in cells
+    unsigned long m_foodAdded, m_measuredFoodAdded; // Food added to the world so far, and when last measured
+    bool m_measured; // Whether the measurements are current
+    int m_actingGroup, m_actingIndex; // Slot of the bacterium acting now (group -1 if none)
+    const Group* acting(const Actor* a, int& i) const; // a's group if a is acting and hasn't moved since it was measured (setting i to its index)
+    Actor* firstFood(Coord x, Coord y, int dist, bool liveOnly) const; // Earliest-added food within dist of (x,y) (nullptr if none)
+    int clampedCell(double v, int n) const; // Column or row containing v, clamped into [0,n)
+};
+
+//////////
+// BacteriaBatch inline implementation
+//////////
+
+inline void BacteriaBatch::reset(int width, int height)
+{
+    m_cols = width / m_cellSize + 1;
+    m_rows = height / m_cellSize + 1;
+    m_cells.assign(m_cols * m_rows, std::vector<int>());
+    m_food.clear();
+    m_foodX.clear();
+    m_foodY.clear();
+    m_foodLive.clear();
+    for (Group& g : m_groups)
+        g.actor.clear();
+    m_slots.clear();
+    finish();
+}
+
+inline void BacteriaBatch::measure(const std::vector<Actor*>& active, const std::vector<Actor*>& actors, const Actor* player)
+{
+    // Index the food (all of it is dormant, so it's only in actors), in sequence order so each cell's list is too
+    m_food.clear();
+    m_foodX.clear();
+    m_foodY.clear();
+    m_foodLive.clear();
+    for (std::vector<int>& cell : m_cells)
+        cell.clear();
+    for (Actor* a : actors)
+    {
+        if (!a->isEdible())
+            continue;
+        m_cells[clampedCell(a->getY(), m_rows) * m_cols + clampedCell(a->getX(), m_cols)].push_back(static_cast<int>(m_food.size()));
+        m_food.push_back(a);
+        m_foodX.push_back(a->getCoordX());
+        m_foodY.push_back(a->getCoordY());
+        m_foodLive.push_back(!a->isDead());
+    }
+    // Gather the live bacteria by species
+    for (Group& g : m_groups)
+    {
+        g.actor.clear();
+        g.x.clear();
+        g.y.clear();
+    }
+    m_slots.assign(active.size(), Slot{-1, 0});
+    for (size_t i = 0; i < active.size(); i++)
+    {
+        Actor* a = active[i];
+        int species = (a->getImageID() == IID_ECOLI ? ECOLI : (a->getImageID() == IID_SALMONELLA ? SALMONELLA : -1));
+        if (species < 0 || a->isDead()) // Not a bacterium, or won't act this tick
+            continue;
+        Group& g = m_groups[species];
+        m_slots[i] = Slot{species, static_cast<int>(g.actor.size())};
+        g.actor.push_back(a);
+        g.x.push_back(a->getCoordX());
+        g.y.push_back(a->getCoordY());
+    }
+    // Measure each species
+    Coord px = player->getCoordX(), py = player->getCoordY();
+    for (int s = 0; s < N_SPECIES; s++)
+    {
+        Group& g = m_groups[s];
+        size_t n = g.actor.size();
+        g.playerDist.resize(n);
+        const Coord* xs = g.x.data();
+        const Coord* ys = g.y.data();
+        CoordDistance* dist = g.playerDist.data();
+        for (size_t i = 0; i < n; i++) // One straight pass over the arrays (GCC vectorizes it at -O3 when sqrt needn't set errno)
+            dist[i] = coordDistance(xs[i], ys[i], px, py);
+        g.eat.resize(n);
+        for (size_t i = 0; i < n; i++)
+            g.eat[i] = firstFood(xs[i], ys[i], 2*SPRITE_RADIUS, true); // Same test as eating: overlapping and alive
+        g.search.assign(n, nullptr);
+        g.searched.assign(n, false);
+        if (s != SALMONELLA)
+            continue;
+        for (size_t i = 0; i < n; i++)
+        {
+            if (static_cast<Bacteria*>(g.actor[i])->getPlanDist() != 0) // Will follow its plan instead of looking for food
+                continue;
+            g.search[i] = firstFood(xs[i], ys[i], Salmonella::FOOD_RANGE, false); // Same test as looking for food: in range, dead or alive
+            g.searched[i] = true;
+        }
+    }
+    m_measuredFoodAdded = m_foodAdded;
+    m_measured = true;
+    m_actingGroup = -1;
+}
+
+inline void BacteriaBatch::setActing(int i)
+{
+    if (m_measured && i >= 0 && static_cast<size_t>(i) < m_slots.size()) // Actors added since measure have no slot
+    {
+        m_actingGroup = m_slots[i].group;
+        m_actingIndex = m_slots[i].index;
+    }
+    else
+        m_actingGroup = -1;
+}
+
+inline const BacteriaBatch::Group* BacteriaBatch::acting(const Actor* a, int& i) const
+{
+    if (m_actingGroup < 0)
+        return nullptr;
+    const Group& g = m_groups[m_actingGroup];
+    i = m_actingIndex;
+    if (g.actor[i] != a || a->getCoordX() != g.x[i] || a->getCoordY() != g.y[i]) // Some other actor, or it has moved
+        return nullptr;
+    return &g;
+}
+
+inline bool BacteriaBatch::playerDistance(const Actor* a, CoordDistance& dist) const
+{
+    int i;
+    const Group* g = acting(a, i);
+    if (g == nullptr) // Socrates doesn't move during the actor loop, so only a's own move matters
+        return false;
+    dist = g->playerDist[i];
+    return true;
+}
+
+inline bool BacteriaBatch::foodToEat(const Actor* a, Actor*& food) const
+{
+    int i;
+    const Group* g = acting(a, i);
+    if (g == nullptr || m_foodAdded != m_measuredFoodAdded) // New food would be a candidate it hasn't measured
+        return false;
+    if (g->eat[i] != nullptr && g->eat[i]->isDead()) // Eaten since, so a later food might be the answer now
+        return false;
+    food = g->eat[i];
+    return true;
+}
+
+inline bool BacteriaBatch::foodInRange(const Actor* a, int dist, Actor*& food) const
+{
+    int i;
+    const Group* g = acting(a, i);
+    if (g == nullptr || m_foodAdded != m_measuredFoodAdded || dist != Salmonella::FOOD_RANGE || !g->searched[i])
+        return false;
+    food = g->search[i]; // Dead food still counts, and stays in the world until the end of the tick
+    return true;
+}
+
+inline Actor* BacteriaBatch::firstFood(Coord x, Coord y, int dist, bool liveOnly) const
+{
+    double cx = x, cy = y;
+    int c0 = clampedCell(cx - dist, m_cols), c1 = clampedCell(cx + dist, m_cols);
+    int r0 = clampedCell(cy - dist, m_rows), r1 = clampedCell(cy + dist, m_rows);
+    int first = -1;
+    for (int r = r0; r <= r1; r++)
+        for (int c = c0; c <= c1; c++)
+            for (int k : m_cells[r * m_cols + c])
+            {
+                if (first >= 0 && k >= first) // Each cell is in sequence order, so nothing later in it can be earlier
+                    break;
+                if ((!liveOnly || m_foodLive[k]) && coordsWithin(x, y, m_foodX[k], m_foodY[k], dist))
+                    first = k;
+            }
+    return first < 0 ? nullptr : m_food[first];
+}
+
+inline int BacteriaBatch::clampedCell(double v, int n) const
+{
+    int c = static_cast<int>(std::floor(v / m_cellSize));
+    return c < 0 ? 0 : (c >= n ? n - 1 : c);
+}
+
+#endif // BACTERIABATCH_H_
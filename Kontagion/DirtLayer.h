@@ -0,0 +1,204 @@
+#ifndef DIRTLAYER_H_
+#define DIRTLAYER_H_
+
+#include "GraphObject.h"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+//////////
+// DirtLayer class declaration
+//////////
+
+// All the dirt in the dish, stored as plain coordinate arrays instead of one Actor per pile.
+// Dirt never moves, never acts, blocks bacteria and dies on any hit, so all it needs is a position and an alive bit.
+// Dirt is indexed by grid cell (built once after the level is set up) so hit and blocking checks only look at nearby piles,
+// and it is drawn as a single SpriteBatch.
+// A pile that is hit stops taking damage right away but keeps blocking bacteria until sweep() at the end of the tick,
+// just like a dead Dirt actor used to until it was deleted.
+
+class DirtLayer
+{
+public:
+    DirtLayer() : m_sprites(IID_DIRT, 0, 1), m_cellSize(MIN_CELL_SIZE), m_cols(0), m_rows(0), m_nAlive(0), m_indexed(false) {m_sprites.setStatic(true);} // Dirt never moves, so it is drawn with the static layer
+    void reset(int width, int height); // Remove all dirt and size the index to cover a width x height dish
+    void add(int x, int y); // Add a pile of dirt at (x,y)
+    int count() const {return m_nAlive;} // Number of piles not yet hit
+    bool damageNear(double x, double y, double radius); // Kill the earliest-added live pile within radius of (x,y), returns whether there was one
+    bool blocks(double x, double y, double radius); // Returns whether any pile (including ones hit this tick) is within radius of (x,y)
+    void sweep(); // Remove piles hit this tick (called once per tick)
+    template<typename Func>
+    void forEachLiveNear(double x, double y, double radius, Func f); // Call f(index, x, y) for live piles in cells within radius of (x,y) (callers check exact distance)
+    void kill(int i); // Hit pile i (it keeps blocking until sweep)
+    bool isAlive(int i) const {return test(m_alive, i);} // Whether pile i hasn't been hit
+
+private:
+    static const int MIN_CELL_SIZE = 16; // Same cell size as ActorGrid
+    static const int MAX_CELLS_PER_SIDE = 1024;
+    GraphObject::SpriteBatch m_sprites; // Sprites of the piles still present
+    std::vector<int> m_x, m_y; // Pile coords, in the order added
+    std::vector<uint64_t> m_alive; // Bit per pile: not hit yet
+    std::vector<uint64_t> m_present; // Bit per pile: not swept yet (hit piles stay until sweep)
+    int m_cellSize; // Cell side length in pixels
+    int m_cols, m_rows; // Grid dimensions in cells
+    std::vector<uint32_t> m_cellStart; // Index of each cell's first entry in m_cellPiles (plus one past the end)
+    std::vector<uint32_t> m_cellPiles; // Pile indices sorted by cell, ascending within each cell
+    int m_nAlive; // Number of piles not yet hit
+    bool m_indexed; // Whether the cell index is up to date
+    void buildIndex(); // Bucket piles by cell
+    int clampedCol(double x) const; // Column containing x, clamped into the grid
+    int clampedRow(double y) const; // Row containing y, clamped into the grid
+    bool within(int i, double x, double y, double radius) const {return coordsWithin(m_x[i], m_y[i], x, y, radius);} // Same test as the world's withinDistance
+    static bool test(const std::vector<uint64_t>& bits, int i) {return (bits[i >> 6] >> (i & 63)) & 1;}
+    static void clear(std::vector<uint64_t>& bits, int i) {bits[i >> 6] &= ~(uint64_t(1) << (i & 63));}
+    template<typename Func>
+    void forEachNear(double x, double y, double radius, Func f); // Call f(index) for every pile in a cell within radius of (x,y)
+};
+
+//////////
+// DirtLayer inline implementation
+//////////
+
+inline void DirtLayer::reset(int width, int height)
+{
+    m_cellSize = MIN_CELL_SIZE;
+    while (width / m_cellSize > MAX_CELLS_PER_SIDE || height / m_cellSize > MAX_CELLS_PER_SIDE)
+        m_cellSize *= 2;
+    m_cols = width / m_cellSize + 1;
+    m_rows = height / m_cellSize + 1;
+    m_x.clear();
+    m_y.clear();
+    m_alive.clear();
+    m_present.clear();
+    m_cellStart.clear();
+    m_cellPiles.clear();
+    m_sprites.clear();
+    m_nAlive = 0;
+    m_indexed = false;
+}
+
+inline void DirtLayer::add(int x, int y)
+{
+    int i = static_cast<int>(m_x.size());
+    m_x.push_back(x);
+    m_y.push_back(y);
+    if ((i & 63) == 0) // Start a new word of bits
+    {
+        m_alive.push_back(0);
+        m_present.push_back(0);
+    }
+    m_alive[i >> 6] |= uint64_t(1) << (i & 63);
+    m_present[i >> 6] |= uint64_t(1) << (i & 63);
+    m_sprites.add(x, y);
+    m_nAlive++;
+    m_indexed = false; // Rebuilt on the next query
+}
+
+inline bool DirtLayer::damageNear(double x, double y, double radius)
+{
+    int first = -1;
+    forEachNear(x, y, radius, [&](int i)
+    {
+        if ((first < 0 || i < first) && test(m_alive, i) && within(i, x, y, radius))
+            first = i;
+    });
+    if (first < 0)
+        return false;
+    kill(first); // Dirt dies from any amount of damage
+    return true;
+}
+
+template<typename Func>
+void DirtLayer::forEachLiveNear(double x, double y, double radius, Func f)
+{
+    forEachNear(x, y, radius, [&](int i)
+    {
+        if (test(m_alive, i))
+            f(i, m_x[i], m_y[i]);
+    });
+}
+
+inline void DirtLayer::kill(int i)
+{
+    if (!test(m_alive, i))
+        return;
+    clear(m_alive, i);
+    m_nAlive--;
+}
+
+inline bool DirtLayer::blocks(double x, double y, double radius)
+{
+    bool blocked = false;
+    forEachNear(x, y, radius, [&](int i)
+    {
+        if (!blocked && test(m_present, i) && within(i, x, y, radius))
+            blocked = true;
+    });
+    return blocked;
+}
+
+inline void DirtLayer::sweep()
+{
+    bool changed = false;
+    for (size_t w = 0; w < m_alive.size(); w++)
+    {
+        if (m_present[w] != m_alive[w])
+        {
+            m_present[w] = m_alive[w];
+            changed = true;
+        }
+    }
+    if (!changed)
+        return;
+    // Redraw only the piles still present
+    m_sprites.clear();
+    for (int i = 0; i < static_cast<int>(m_x.size()); i++)
+    {
+        if (test(m_present, i))
+            m_sprites.add(m_x[i], m_y[i]);
+    }
+}
+
+inline void DirtLayer::buildIndex()
+{
+    // Counting sort of pile indices by cell (stable, so each cell's indices stay ascending)
+    m_cellStart.assign(m_cols * m_rows + 1, 0);
+    for (size_t i = 0; i < m_x.size(); i++)
+        m_cellStart[clampedRow(m_y[i]) * m_cols + clampedCol(m_x[i]) + 1]++;
+    for (size_t c = 1; c < m_cellStart.size(); c++)
+        m_cellStart[c] += m_cellStart[c-1];
+    m_cellPiles.resize(m_x.size());
+    std::vector<uint32_t> next(m_cellStart.begin(), m_cellStart.end() - 1);
+    for (size_t i = 0; i < m_x.size(); i++)
+        m_cellPiles[next[clampedRow(m_y[i]) * m_cols + clampedCol(m_x[i])]++] = static_cast<uint32_t>(i);
+    m_indexed = true;
+}
+
+template<typename Func>
+void DirtLayer::forEachNear(double x, double y, double radius, Func f)
+{
+    if (m_x.empty())
+        return;
+    if (!m_indexed)
+        buildIndex();
+    int c0 = clampedCol(x - radius), c1 = clampedCol(x + radius);
+    int r0 = clampedRow(y - radius), r1 = clampedRow(y + radius);
+    for (int r = r0; r <= r1; r++)
+        for (int c = c0; c <= c1; c++)
+            for (uint32_t k = m_cellStart[r * m_cols + c]; k < m_cellStart[r * m_cols + c + 1]; k++)
+                f(static_cast<int>(m_cellPiles[k]));
+}
+
+inline int DirtLayer::clampedCol(double x) const
+{
+    int c = static_cast<int>(std::floor(x / m_cellSize));
+    return c < 0 ? 0 : (c >= m_cols ? m_cols - 1 : c);
+}
+
+inline int DirtLayer::clampedRow(double y) const
+{
+    int r = static_cast<int>(std::floor(y / m_cellSize));
+    return r < 0 ? 0 : (r >= m_rows ? m_rows - 1 : r);
+}
+
+#endif // DIRTLAYER_H_
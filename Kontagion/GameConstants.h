@@ -2,6 +2,7 @@
 #define GAMECONSTANTS_H_
 
 #include <random>
+#include <cstdlib>
 #include <utility>
 
 // image IDs for the game objects
@@ -36,6 +37,10 @@ const int SOUND_BACTERIUM_BORN  = 11;
 
 const int SOUND_NONE            = -1;
 
+// Every sound ID must be below this: the sound event queue and the audio engine
+// track sounds in 64-bit masks with one bit per ID
+const int MAX_SOUND_IDS         = 64;
+
 
 // keys the user can hit
 
@@ -61,6 +66,84 @@ const int SPRITE_RADIUS = 4;
 const double SPRITE_WIDTH_GL = .3; // note - this is tied implicitly to SPRITE_WIDTH due to carey's sloppy openGL programming
 const double SPRITE_HEIGHT_GL = .25; // note - this is tied implicitly to SPRITE_HEIGHT due to carey's sloppy openGL programming
 
+// dish dimensions
+//
+// The classic dish exactly fills the VIEW_WIDTH x VIEW_HEIGHT view.  Large-dish
+// mode makes the world bigger (sprites keep their size in world units) and
+// the view is scaled down to show all of it.  Set it up once at startup,
+// before the world is initialized.
+
+const int CLASSIC_SPAWN_RADIUS = 120;   // pits, food and dirt are placed within this of the center
+const int MAX_DISH_RADIUS = 65536;
+
+struct DishDimensions
+{
+    int    width = VIEW_WIDTH;
+    int    height = VIEW_HEIGHT;
+    int    radius = VIEW_RADIUS;
+    int    spawnRadius = CLASSIC_SPAWN_RADIUS;
+    double density = 1.0;   // multiplies the level's pit, food and dirt counts on top of area scaling
+
+    int centerX() const { return width / 2; }
+    int centerY() const { return height / 2; }
+
+      // How many times the classic dish's area this dish's spawn area is, times the density
+    double populationScale() const
+    {
+        double r = double(spawnRadius) / CLASSIC_SPAWN_RADIUS;
+        return r * r * density;
+    }
+};
+
+inline
+DishDimensions& dishDimensions()
+{
+    static DishDimensions dims;
+    return dims;
+}
+
+inline
+const DishDimensions& dish()
+{
+    return dishDimensions();
+}
+
+inline
+void setDishRadius(int radius, double density = 1.0)
+{
+    if (radius < VIEW_RADIUS)
+        radius = VIEW_RADIUS;
+    else if (radius > MAX_DISH_RADIUS)
+        radius = MAX_DISH_RADIUS;
+    DishDimensions& d = dishDimensions();
+    d.radius = radius;
+    d.width = d.height = 2 * radius;
+    d.spawnRadius = radius - (VIEW_RADIUS - CLASSIC_SPAWN_RADIUS);
+    d.density = (density > 0 ? density : 1.0);
+}
+
+// optional gameplay modes
+//
+// Alternatives to the classic rules, chosen once at startup.  With every
+// option off the game plays exactly as the spec describes.
+
+struct GameOptions
+{
+    bool sweptProjectiles = false;  // sprays and flames hit anything their path crossed since the last tick
+    bool flameBursts = false;       // a flame charge is one ring-shaped actor instead of 16 Flames (same hits)
+    bool autoPlay = false;          // Socrates is played by AutoPlayer instead of the keyboard
+    bool batchedBacteria = false;   // bacteria's distance and food queries are measured for all of them at once each tick (same results)
+    bool sampledEvents = false;     // pit emissions and new goodies are drawn as ticks-until-next (same odds, other sequence)
+    bool memoryReport = false;      // the world prints its actor memory by type when each level is cleaned up
+};
+
+inline
+GameOptions& gameOptions()
+{
+    static GameOptions options;
+    return options;
+}
+
 
 // status of each tick (did the player die?)
 
@@ -73,15 +156,41 @@ const int GWSTATUS_LEVEL_ERROR    = 4;
 
   // Return a uniformly distributed random int from min to max, inclusive
 
+inline
+std::default_random_engine& randomEngine()
+{
+    static std::random_device rd;
+    static std::default_random_engine generator(rd());
+    return generator;
+}
+
 inline
 int randInt(int min, int max)
 {
     if (max < min)
         std::swap(max, min);
-    static std::random_device rd;
-    static std::default_random_engine generator(rd());
     std::uniform_int_distribution<> distro(min, max);
-    return distro(generator);
+    return distro(randomEngine());
+}
+
+  // Return how many ticks from now an event with a 1 in oneIn chance each
+  // tick next happens (at least 1).  This is one draw per event instead of
+  // one randInt(0, oneIn-1) == 0 test per tick, with the same distribution.
+inline
+int randTicksUntil(int oneIn)
+{
+    if (oneIn <= 1)
+        return 1;
+    std::geometric_distribution<int> distro(1.0 / oneIn);
+    return 1 + distro(randomEngine());
+}
+
+  // Make randInt (and rand) produce the same sequence on every run
+inline
+void seedRandom(unsigned int seed)
+{
+    randomEngine().seed(seed);
+    std::srand(seed);
 }
 
 #endif // GAMECONSTANTS_H_
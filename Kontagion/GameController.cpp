@@ -3,13 +3,17 @@
 #include "GameWorld.h"
 #include "GameConstants.h"
 #include "GraphObject.h"
-#include "SoundFX.h"
 #include "SpriteManager.h"
+#include "Profiler.h"
 #include <string>
 #include <map>
 #include <utility>
 #include <cstdlib>
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include <random>
 using namespace std;
 
 /*
@@ -43,6 +47,13 @@ static const double SCORE_Z = -10;
 
 static const int MS_PER_FRAME = 5;
 
+  // In threaded mode the simulation keeps the same pace it has when it shares
+  // the GLUT thread: one makemove plus ANIMATION_POSITIONS_PER_TICK+1 animate
+  // frames per tick.
+static const int MS_PER_SIM_TICK = MS_PER_FRAME * (ANIMATION_POSITIONS_PER_TICK + 2);
+
+static const int SOUND_RATE_LIMIT_TICKS = 4;
+
 struct SpriteInfo
 {
     int         imageID;
@@ -50,15 +61,15 @@ struct SpriteInfo
     std::string tgaFileName;
 };
 
-static void drawPrompt(string mainMessage, string secondMessage);
-static void drawScoreAndLives(string);
+static void drawPrompt(StrokeTextCache& cache, const string& mainMessage, const string& secondMessage);
+static void drawScoreAndLives(StrokeTextCache& cache, const char* gameStatText);
 
 enum GameController::GameControllerState : int {
-    welcome, init, makemove, animate, contgame, finishedlevel, cleanup,
-    gameover, prompt, quit, not_applicable
+    welcome, init, makemove, animate, simulate, contgame, finishedlevel,
+    cleanup, gameover, prompt, quit, not_applicable
 };
 
-void GameController::initDrawersAndSounds()
+void GameController::startLoadingAssets()
 {
     SpriteInfo drawers[] = {
 	{ IID_PLAYER               , 0, "socrates.tga" },
@@ -94,14 +105,79 @@ void GameController::initDrawersAndSounds()
 	make_pair(SOUND_BACTERIUM_BORN , "born.wav")
     };
 
+      // Every file is read and decoded on the loader's worker threads.
+      // Sounds go first since they are needed for the welcome theme;
+      // textures are uploaded by the GLUT thread as they become ready.
     string path = m_gw->assetPath();
-    for (const SpriteInfo& d : drawers)
+    for (const auto& s : sounds)
+    {
+        int soundID = s.first;
+        string fileName = path + s.second;
+        m_soundTasks.push_back(m_assetLoader.add([this, soundID, fileName]() {
+              // Resolve (and, when mixing, decode) every clip once up front
+            m_audio.loadClip(soundID, fileName);
+        }));
+    }
+    m_pendingSprites.resize(sizeof(drawers) / sizeof(drawers[0]));
+    for (size_t i = 0; i < m_pendingSprites.size(); i++)
+    {
+        PendingSprite& p = m_pendingSprites[i];
+        p.imageID = drawers[i].imageID;
+        p.frameNum = drawers[i].frameNum;
+        p.fileName = path + drawers[i].tgaFileName;
+        p.task = m_assetLoader.add([&p]() {
+            p.readOK = SpriteManager::readSprite(p.fileName, p.image);
+        });
+    }
+    m_assetLoader.start();
+
+      // Bacteria sounds can fire for dozens of actors in a row; a few per
+      // second of each is plenty
+    for (int soundID : { SOUND_SALMONELLA_HURT, SOUND_SALMONELLA_DIE, SOUND_ECOLI_HURT,
+                         SOUND_ECOLI_DIE, SOUND_BACTERIUM_BORN })
+        m_gw->soundEvents().setRateLimit(soundID, SOUND_RATE_LIMIT_TICKS);
+}
+
+  // Upload whatever textures have finished decoding and start the audio
+  // thread once every clip is loaded.  With waitForAll, block until every
+  // asset is in place.
+void GameController::uploadLoadedAssets(bool waitForAll)
+{
+    if (m_assetsLoaded)
+        return;
+    if (waitForAll)
+        m_assetLoader.wait();
+
+    bool soundsLoaded = all_of(m_soundTasks.begin(), m_soundTasks.end(),
+                               [this](size_t task) { return m_assetLoader.isDone(task); });
+    if (soundsLoaded  &&  !m_soundTasks.empty())
     {
-        if (!m_spriteManager.loadSprite(path + d.tgaFileName, d.imageID, d.frameNum))
+        m_audio.start();
+        m_soundTasks.clear();
+    }
+
+    bool spritesLoaded = true;
+    for (PendingSprite& p : m_pendingSprites)
+    {
+        if (p.uploaded)
+            continue;
+        if (!m_assetLoader.isDone(p.task))
+        {
+            spritesLoaded = false;
+            continue;
+        }
+        if (!p.readOK  ||  !m_spriteManager.uploadSprite(p.image, p.imageID, p.frameNum))
             exit(1);
+        p.uploaded = true;
+        p.image = SpriteManager::SpriteImage();     // unmap or free the pixels
+    }
+
+    if (soundsLoaded  &&  spritesLoaded)
+    {
+        m_assetLoader.wait();
+        m_pendingSprites.clear();
+        m_assetsLoaded = true;
     }
-    for (const auto& s : sounds)
-        m_soundMap[s.first] = s.second;
 }
 
 static void doSomethingCallback()
@@ -147,7 +223,16 @@ void GameController::run(int argc, char* argv[], GameWorld* gw, string windowTit
     glutInitWindowPosition(0, 0);
     glutCreateWindow(windowTitle.c_str());
 
-    initDrawersAndSounds();
+    startLoadingAssets();
+
+    if (m_benchmarkSprites > 0)
+    {
+        uploadLoadedAssets(true);
+        runDrawBenchmark();
+        m_audio.stop();
+        delete m_gw;
+        return;
+    }
 
     glutKeyboardFunc(keyboardEventCallback);
     glutSpecialFunc(specialKeyboardEventCallback);
@@ -157,6 +242,8 @@ void GameController::run(int argc, char* argv[], GameWorld* gw, string windowTit
 
     glutSetOption(GLUT_ACTION_ON_WINDOW_CLOSE, GLUT_ACTION_GLUTMAINLOOP_RETURNS);
     glutMainLoop();
+    stopSimThread();
+    m_audio.stop();
     delete m_gw;
 }
 
@@ -190,15 +277,15 @@ void GameController::specialKeyboardEvent(int key, int /* x */, int /* y */)
 
 void GameController::playSound(int soundID)
 {
-    if (soundID == SOUND_NONE)
-    {
-        SoundFX().abortClip();
-        return;
-    }
+      // Only queues the sound; the audio thread plays it once the tick is
+      // committed.  Sounds from inside move() come through playTickSounds.
+    m_audio.play(soundID);
+}
 
-    SoundMapType::const_iterator p = m_soundMap.find(soundID);
-    if (p != m_soundMap.end())
-        SoundFX().playClip(m_gw->assetPath() + p->second);
+void GameController::playTickSounds()
+{
+    m_gw->soundEvents().drain([this](int soundID) { m_audio.play(soundID); });
+    m_audio.commitTick();
 }
 
 void GameController::setGameState(GameControllerState s)
@@ -218,23 +305,49 @@ void GameController::setGameStateAfterPrompting(GameControllerState s,
 
 void GameController::quitGame()
 {
-    setGameState(quit);
+      // May be called from the simulation thread, so just leave a note for
+      // the GLUT thread to act on
+    m_quitRequested = true;
+}
+
+GameController::GameControllerState GameController::stateAfterMove(int status)
+{
+    if (status == GWSTATUS_PLAYER_DIED)
+    {
+          // animate one last frame so the player can see what happened
+        return m_gw->isGameOver() ? gameover : contgame;
+    }
+    else if (status == GWSTATUS_FINISHED_LEVEL)
+    {
+        m_gw->advanceToNextLevel();
+          // animate one last frame so the player can see what happened
+        return finishedlevel;
+    }
+    return not_applicable;
 }
 
 void GameController::doSomething()
 {
+    if (m_quitRequested)
+        setGameState(quit);
+
+      // Keep loading while the welcome prompt is up
+    uploadLoadedAssets(false);
+
     switch (m_gameState)
     {
         case not_applicable:
             break;
         case welcome:
             playSound(SOUND_THEME);
+            m_audio.commitTick();
             setGameStateAfterPrompting(init, "Welcome to Kontagion!", "Press Enter to begin play...");
             break;
         case init:
             {
                 int status = m_gw->init();
-                SoundFX().abortClip();
+                playSound(SOUND_NONE);
+                m_audio.commitTick();
                 if (status == GWSTATUS_PLAYER_WON)
                 {
                     m_playerWon = true;
@@ -251,22 +364,16 @@ void GameController::doSomething()
             }
             break;
         case makemove:
-            m_curIntraFrameTick = ANIMATION_POSITIONS_PER_TICK;
-            m_nextStateAfterAnimate = not_applicable;
+            if (m_threadedSim)
             {
-                int status = m_gw->move();
-                if (status == GWSTATUS_PLAYER_DIED)
-                {
-                      // animate one last frame so the player can see what happened
-                    m_nextStateAfterAnimate = (m_gw->isGameOver() ? gameover : contgame);
-                }
-                else if (status == GWSTATUS_FINISHED_LEVEL)
-                {
-                    m_gw->advanceToNextLevel();
-                      // animate one last frame so the player can see what happened
-                    m_nextStateAfterAnimate = finishedlevel;
-                }
+                startSimThread();
+                setGameState(simulate);
+                break;
             }
+            m_curIntraFrameTick = ANIMATION_POSITIONS_PER_TICK;
+            m_nextStateAfterAnimate = stateAfterMove(m_gw->move());
+            playTickSounds();
+            GraphObject::advanceAnimationTick();
             setGameState(animate);
             break;
         case animate:
@@ -283,6 +390,22 @@ void GameController::doSomething()
                 }
             }
             break;
+        case simulate:
+            {
+                  // Check before drawing so the final snapshot of a finished
+                  // run is the one that gets drawn
+                bool finished = !m_simThread.joinable()  ||  m_simStatus != GWSTATUS_CONTINUE_GAME;
+                displaySnapshot(m_snapshots.latest());
+                if (finished)
+                {
+                    int status = m_simStatus;
+                    stopSimThread();
+                    GameControllerState next = stateAfterMove(status);
+                    if (next != not_applicable)
+                        setGameState(next);
+                }
+            }
+            break;
         case contgame:
             setGameStateAfterPrompting(cleanup, "You lost a life!",
                                         "Press Enter to continue playing...");
@@ -305,22 +428,52 @@ void GameController::doSomething()
             }
             break;
         case prompt:
-            drawPrompt(m_mainMessage, m_secondMessage);
+            drawPrompt(m_strokeText, m_mainMessage, m_secondMessage);
             {
                 int key;
                 if (getLastKey(key) && key == '\r')
+                {
+                    uploadLoadedAssets(true);     // can't play until everything is loaded
                     setGameState(m_nextStateAfterPrompt);
+                }
             }
             break;
         case quit:
-            SoundFX().abortClip();
+            stopSimThread();
+            m_audio.stop();
             glutLeaveMainLoop();
             break;
     }
 }
 
+  // Draw the static layer (static sprites, then the dish outline) from its
+  // display list, first recording it again with drawSprites() if the layer
+  // has changed since.  Without a display list, just draw it.
+template<typename Func>
+void GameController::drawStaticLayer(unsigned long version, Func drawSprites)
+{
+    if (m_staticList == 0)
+        m_staticList = glGenLists(1);
+    if (m_staticList == 0)
+    {
+        drawSprites();
+        SpriteManager::drawCircle(dish().centerX(), dish().centerY(), dish().radius + SPRITE_WIDTH, 100);
+        return;
+    }
+    if (version != m_staticListVersion)
+    {
+        glNewList(m_staticList, GL_COMPILE);
+        drawSprites();
+        SpriteManager::drawCircle(dish().centerX(), dish().centerY(), dish().radius + SPRITE_WIDTH, 100);
+        glEndList();
+        m_staticListVersion = version;
+    }
+    glCallList(m_staticList);
+}
+
 void GameController::displayGamePlay()
 {
+    PROFILE_SCOPE("GameController::displayGamePlay");
     glEnable(GL_DEPTH_TEST); // must be done each time before displaying graphics or gets disabled for some reason
     glLoadIdentity();
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -333,20 +486,216 @@ void GameController::displayGamePlay()
 #pragma GCC diagnostic pop
 #endif
 
-    GraphObject::drawAllObjects(
-        [=](int imageID, int animationNumber, double x, double y, int angle, double size)
+    auto plot = [=](int imageID, unsigned int animationNumber, double x, double y, int angle, double size)
         {
-            int frame = animationNumber % m_spriteManager.getNumFrames(imageID);
+            int frame = m_spriteManager.getFrame(imageID, animationNumber);
             m_spriteManager.plotSprite(imageID, frame, x, y, angle, size);
-        });
+        };
+
+    if (m_cacheStaticLayer)
+    {
+        drawStaticLayer(GraphObject::getStaticLayerVersion(), [&] { GraphObject::drawStaticObjects(plot); });
+        GraphObject::drawDynamicObjects(plot);
+    }
+    else
+        GraphObject::drawAllObjects(plot);
+
+    drawScoreAndLives(m_strokeText, m_gameStatText);
+
+    if (!m_cacheStaticLayer)
+        SpriteManager::drawCircle(dish().centerX(), dish().centerY(), dish().radius + SPRITE_WIDTH, 100);
+
+    glutSwapBuffers();
+}
+
+void GameController::startSimThread()
+{
+    stopSimThread();
+    m_snapshots.clear();
+    m_simStatus = GWSTATUS_CONTINUE_GAME;
+    m_simThread = thread(&GameController::runSimThread, this);
+}
+
+void GameController::stopSimThread()
+{
+    if (!m_simThread.joinable())
+        return;
+    m_stopSim = true;
+    m_simThread.join();
+    m_stopSim = false;
+}
+
+void GameController::runSimThread()
+{
+    using Clock = chrono::steady_clock;
+    Clock::time_point nextTick = Clock::now();
+    while (!m_stopSim  &&  !m_quitRequested)
+    {
+        int status = m_gw->move();
+        playTickSounds();
+        GraphObject::advanceAnimationTick();
+        publishSnapshot();
+        if (status != GWSTATUS_CONTINUE_GAME)
+        {
+            m_simStatus = status;
+            return;
+        }
 
-    drawScoreAndLives(m_gameStatText);
+        nextTick += chrono::milliseconds(MS_PER_SIM_TICK);
+        this_thread::sleep_until(nextTick);
 
-    SpriteManager::drawCircle(VIEW_WIDTH / 2, VIEW_HEIGHT / 2, VIEW_WIDTH / 2 + SPRITE_WIDTH, 100);
+          // In single-step mode, wait for a key before each further move
+        int key;
+        while (m_singleStep  &&  !getLastKey(key)  &&  !m_stopSim  &&  !m_quitRequested)
+        {
+            this_thread::sleep_for(chrono::milliseconds(MS_PER_FRAME));
+            nextTick = Clock::now();
+        }
+    }
+}
+
+  // A drawAllObjects callback that appends each sprite to sprites
+static auto recordSprites(vector<SpriteRecord>& sprites)
+{
+    return [&sprites](int imageID, unsigned int animationNumber, double x, double y, int angle, double size)
+        {
+            sprites.push_back(SpriteRecord{ imageID, animationNumber, x, y, angle, size });
+        };
+}
+
+void GameController::publishSnapshot()
+{
+    RenderSnapshot& snapshot = m_snapshots.backBuffer();
+    snapshot.sprites.clear();
+    if (m_cacheStaticLayer)
+    {
+          // Copy the static sprites only if this buffer has an older version
+        unsigned long version = GraphObject::getStaticLayerVersion();
+        if (snapshot.staticVersion != version)
+        {
+            snapshot.staticSprites.clear();
+            GraphObject::drawStaticObjects(recordSprites(snapshot.staticSprites));
+            snapshot.staticVersion = version;
+        }
+        GraphObject::drawDynamicObjects(recordSprites(snapshot.sprites));
+    }
+    else
+        GraphObject::drawAllObjects(recordSprites(snapshot.sprites));
+    snapshot.gameStatText = m_gameStatText;
+    snapshot.tick = ++m_simTick;
+    m_snapshots.publish();
+}
+
+void GameController::displaySnapshot(const RenderSnapshot& snapshot)
+{
+    PROFILE_SCOPE("GameController::displaySnapshot");
+    glEnable(GL_DEPTH_TEST); // must be done each time before displaying graphics or gets disabled for some reason
+    glLoadIdentity();
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+#ifdef _MSC_VER
+    gluLookAt(0, 0, 0, 0, 0, -1, 0, 1, 0);
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+    gluLookAt(0, 0, 0, 0, 0, -1, 0, 1, 0);
+#pragma GCC diagnostic pop
+#endif
+
+    auto plotAll = [this](const vector<SpriteRecord>& sprites)
+        {
+            for (const SpriteRecord& r : sprites)
+            {
+                int frame = m_spriteManager.getFrame(r.imageID, r.animationNumber);
+                m_spriteManager.plotSprite(r.imageID, frame, r.x, r.y, r.direction, r.size);
+            }
+        };
+
+    if (m_cacheStaticLayer)
+        drawStaticLayer(snapshot.staticVersion, [&] { plotAll(snapshot.staticSprites); });
+    plotAll(snapshot.sprites);
+
+    drawScoreAndLives(m_strokeText, snapshot.gameStatText.c_str());
+
+    if (!m_cacheStaticLayer)
+        SpriteManager::drawCircle(dish().centerX(), dish().centerY(), dish().radius + SPRITE_WIDTH, 100);
 
     glutSwapBuffers();
 }
 
+void GameController::runDrawBenchmark()
+{
+    static const int BENCHMARK_FRAMES = 300;
+    using Clock = chrono::steady_clock;
+
+    reshape(WINDOW_WIDTH, WINDOW_HEIGHT);
+
+      // Spread the sprites over the dish, cycling through every loaded image
+    vector<int> imageIDs;
+    for (int imageID = 0; imageID <= IID_FUNGUS; imageID++)
+    {
+        if (m_spriteManager.getNumFrames(imageID) > 0)
+            imageIDs.push_back(imageID);
+    }
+    vector<SpriteRecord> sprites;
+    int perRow = max(1, static_cast<int>(sqrt(double(m_benchmarkSprites))));
+    for (int i = 0; i < m_benchmarkSprites; i++)
+    {
+        double x = (i % perRow + 0.5) * dish().width / perRow;
+        double y = (i / perRow % perRow + 0.5) * dish().height / perRow;
+        sprites.push_back(SpriteRecord{ imageIDs[i % imageIDs.size()], static_cast<unsigned int>(i), x, y, (i * 37) % 360, 1.0 });
+    }
+
+      // Draw every sprite each frame, as displayGamePlay does.  With the
+      // static layer cached, draw them all as a static layer instead (frames
+      // no longer advance, since static sprites don't animate).
+    Clock::time_point start = Clock::now();
+    for (int f = 0; f < BENCHMARK_FRAMES; f++)
+    {
+        glEnable(GL_DEPTH_TEST);
+        glLoadIdentity();
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+#ifdef _MSC_VER
+        gluLookAt(0, 0, 0, 0, 0, -1, 0, 1, 0);
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+        gluLookAt(0, 0, 0, 0, 0, -1, 0, 1, 0);
+#pragma GCC diagnostic pop
+#endif
+        auto plotSprites = [&]
+            {
+                for (const SpriteRecord& r : sprites)
+                {
+                    int frame = m_spriteManager.getFrame(r.imageID, r.animationNumber + f);
+                    m_spriteManager.plotSprite(r.imageID, frame, r.x, r.y, r.direction, r.size);
+                }
+            };
+        if (m_cacheStaticLayer)
+            drawStaticLayer(1, plotSprites);
+        else
+            plotSprites();
+        glFinish();
+    }
+    double drawSeconds = chrono::duration<double>(Clock::now() - start).count();
+
+      // Just the per-sprite bookkeeping: the frame and texture lookups
+    unsigned long checksum = 0;
+    start = Clock::now();
+    for (int f = 0; f < BENCHMARK_FRAMES; f++)
+    {
+        for (const SpriteRecord& r : sprites)
+            checksum += m_spriteManager.getFrame(r.imageID, r.animationNumber + f) + m_spriteManager.getNumFrames(r.imageID);
+    }
+    double lookupSeconds = chrono::duration<double>(Clock::now() - start).count();
+
+    double nDraws = double(BENCHMARK_FRAMES) * sprites.size();
+    cout << "Drew " << sprites.size() << " sprites x " << BENCHMARK_FRAMES << " frames: "
+         << drawSeconds * 1e3 / BENCHMARK_FRAMES << " ms/frame, "
+         << drawSeconds * 1e9 / nDraws << " ns/sprite" << endl;
+    cout << "Frame lookups alone: " << lookupSeconds * 1e9 / nDraws << " ns/sprite"
+         << " (checksum " << checksum << ")" << endl;
+}
+
 void GameController::reshape (int w, int h)
 {
     glViewport (0, 0, (GLsizei) w, (GLsizei) h);
@@ -363,11 +712,11 @@ void GameController::reshape (int w, int h)
     glMatrixMode (GL_MODELVIEW);
 }
 
-static void doOutputStroke(double x, double y, double z, double size, const char* str, bool centered)
+static void doOutputStroke(StrokeTextCache& cache, double x, double y, double z, double size, const char* str, bool centered)
 {
     if (centered)
     {
-        double len = glutStrokeLength(GLUT_STROKE_ROMAN, reinterpret_cast<const unsigned char*>(str)) / FONT_SCALEDOWN;
+        double len = cache.length(str) / FONT_SCALEDOWN;
         x = -len / 2;
         size = 1;
     }
@@ -377,39 +726,44 @@ static void doOutputStroke(double x, double y, double z, double size, const char
     glLoadIdentity();
     glTranslatef(static_cast<GLfloat>(x), static_cast<GLfloat>(y), static_cast<GLfloat>(z));
     glScalef(scaledSize, scaledSize, scaledSize);
-    for ( ; *str != '\0'; str++)
-        glutStrokeCharacter(GLUT_STROKE_ROMAN, *str);
+    cache.draw(str);
     glPopMatrix();
 }
 
-//static void outputStroke(double x, double y, double z, double size, const char* str)
+//static void outputStroke(StrokeTextCache& cache, double x, double y, double z, double size, const char* str)
 //{
-//  doOutputStroke(x, y, z, size, str, false);
+//  doOutputStroke(cache, x, y, z, size, str, false);
 //}
 
-static void outputStrokeCentered(double y, double z, const char* str)
+static void outputStrokeCentered(StrokeTextCache& cache, double y, double z, const char* str)
 {
-    doOutputStroke(0, y, z, 1, str, true);
+    doOutputStroke(cache, 0, y, z, 1, str, true);
 }
 
-static void drawPrompt(string mainMessage, string secondMessage)
+static void drawPrompt(StrokeTextCache& cache, const string& mainMessage, const string& secondMessage)
 {
+    cache.nextFrame();
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     glColor3f (1.0, 1.0, 1.0);
     glLoadIdentity ();
-    outputStrokeCentered(1, -5, mainMessage.c_str());
-    outputStrokeCentered(-1, -5, secondMessage.c_str());
+    outputStrokeCentered(cache, 1, -5, mainMessage.c_str());
+    outputStrokeCentered(cache, -1, -5, secondMessage.c_str());
     glutSwapBuffers();
 }
 
-static void drawScoreAndLives(string gameStatText)
+static void drawScoreAndLives(StrokeTextCache& cache, const char* gameStatText)
 {
+    cache.nextFrame();
     static int RATE = 1;
     static GLfloat rgb[3] =
         { static_cast<GLfloat>(.6), static_cast<GLfloat>(.6), static_cast<GLfloat>(.6) };
+      // The flicker has its own generator so drawing never perturbs the
+      // game's random sequence (or races with it on the simulation thread)
+    static default_random_engine flicker;
+    uniform_int_distribution<> flickerRate(-RATE, RATE);
     for (int k = 0; k < 3; k++)
     {
-        double strength = rgb[k] + randInt(-RATE, RATE) / 100.0;
+        double strength = rgb[k] + flickerRate(flicker) / 100.0;
         if (strength < .6)
             strength = .6;
         else if (strength > 1.0)
@@ -417,5 +771,5 @@ static void drawScoreAndLives(string gameStatText)
         rgb[k] = static_cast<GLfloat>(strength);
     }
     glColor3f(rgb[0], rgb[1], rgb[2]);
-    outputStrokeCentered(SCORE_Y, SCORE_Z, gameStatText.c_str());
+    outputStrokeCentered(cache, SCORE_Y, SCORE_Z, gameStatText);
 }
@@ -2,10 +2,16 @@
 #define GAMECONTROLLER_H_
 
 #include "SpriteManager.h"
+#include "AudioEngine.h"
+#include "RenderSnapshot.h"
+#include "StrokeTextCache.h"
+#include "AssetLoader.h"
 #include <string>
 #include <map>
 #include <iostream>
 #include <sstream>
+#include <atomic>
+#include <thread>
 
 const int INVALID_KEY = 0;
 
@@ -19,10 +25,10 @@ class GameController
 
     bool getLastKey(int& value)
     {
-        if (m_lastKeyHit != INVALID_KEY)
+        int key = m_lastKeyHit.exchange(INVALID_KEY);
+        if (key != INVALID_KEY)
         {
-            value = m_lastKeyHit;
-            m_lastKeyHit = INVALID_KEY;
+            value = key;
             return true;
         }
         return false;
@@ -30,7 +36,14 @@ class GameController
 
     void playSound(int soundID);
 
-    void setGameStatText(std::string text)
+    void setGameStatText(const std::string& text)
+    {
+        m_ownedGameStatText = text;
+        m_gameStatText = m_ownedGameStatText.c_str();
+    }
+
+      // Display text in place; the caller keeps it alive until replaced
+    void setGameStatTextBuffer(const char* text)
     {
         m_gameStatText = text;
     }
@@ -43,6 +56,35 @@ class GameController
 
     void quitGame();
 
+      // Run StudentWorld::move() on its own thread, with the GLUT thread
+      // drawing the latest published snapshot.  Must be set before run().
+    void setThreadedSimulation(bool threaded)
+    {
+        m_threadedSim = threaded;
+    }
+
+      // Choose where sound effects go.  Must be set before run().
+    void setAudioBackend(AudioEngine::Backend backend, std::string wavFileName = "")
+    {
+        m_audio.setBackend(backend, wavFileName);
+    }
+
+      // Instead of playing, draw nSprites sprites for a few hundred frames,
+      // print the time per frame and per sprite, and return from run().
+    void setDrawBenchmark(int nSprites)
+    {
+        m_benchmarkSprites = nSprites;
+    }
+
+      // Draw the dish outline and static sprites (see GraphObject::setStatic)
+      // from a display list that is re-recorded only when one of them
+      // changes, with the rest drawn on top each frame.  Must be set before
+      // run().
+    void setStaticLayerCache(bool cached)
+    {
+        m_cacheStaticLayer = cached;
+    }
+
       // Meyers singleton pattern
     static GameController& getInstance()
     {
@@ -57,24 +99,69 @@ private:
     GameControllerState m_gameState;
     GameControllerState m_nextStateAfterPrompt;
     GameControllerState m_nextStateAfterAnimate;
-    int         m_lastKeyHit;
-    bool        m_singleStep;
-    std::string m_gameStatText;
+    std::atomic<int>  m_lastKeyHit;
+    std::atomic<bool> m_singleStep;
+    std::atomic<bool> m_quitRequested{false};
+    const char* m_gameStatText = "";
+    std::string m_ownedGameStatText;
     std::string m_mainMessage;
     std::string m_secondMessage;
     int         m_curIntraFrameTick;
     using SoundMapType = std::map<int, std::string>;
     using DrawMapType =  std::map<int, std::string>;
-    SoundMapType  m_soundMap;
+    AudioEngine   m_audio;
     bool          m_playerWon;
     SpriteManager m_spriteManager;
+    StrokeTextCache m_strokeText;
+
+      // A sprite being decoded by m_assetLoader, waiting to be uploaded
+    struct PendingSprite
+    {
+        int                         imageID;
+        int                         frameNum;
+        std::string                 fileName;
+        SpriteManager::SpriteImage  image;
+        bool                        readOK = false;
+        bool                        uploaded = false;
+        size_t                      task = 0;
+    };
+
+    AssetLoader                 m_assetLoader;
+    std::vector<PendingSprite>  m_pendingSprites;
+    std::vector<size_t>         m_soundTasks;
+    bool                        m_assetsLoaded = false;
+
+    bool                 m_threadedSim = false;
+    std::thread          m_simThread;
+    std::atomic<bool>    m_stopSim{false};
+    std::atomic<int>     m_simStatus{GWSTATUS_CONTINUE_GAME};
+    RenderSnapshotBuffer m_snapshots;
+    unsigned long        m_simTick = 0;
+
+    int                  m_benchmarkSprites = 0;
+
+    bool                 m_cacheStaticLayer = false;
+    GLuint               m_staticList = 0;          // display list of the static layer
+    unsigned long        m_staticListVersion = 0;   // GraphObject static layer version it holds
 
     void setGameState(GameControllerState s);
     void setGameStateAfterPrompting(GameControllerState s,
                             std::string mainMessage, std::string secondMessage);
+    GameControllerState stateAfterMove(int status);
+    void playTickSounds();
 
-    void initDrawersAndSounds();
+    void startLoadingAssets();
+    void uploadLoadedAssets(bool waitForAll);
     void displayGamePlay();
+
+    void startSimThread();
+    void stopSimThread();
+    void runSimThread();
+    void publishSnapshot();
+    void displaySnapshot(const RenderSnapshot& snapshot);
+    template<typename Func>
+    void drawStaticLayer(unsigned long version, Func drawSprites);
+    void runDrawBenchmark();
 };
 
 inline GameController& Game()
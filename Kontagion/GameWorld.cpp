@@ -2,10 +2,20 @@
 #include "GameController.h"
 #include <string>
 #include <cstdlib>
+#include <chrono>
 using namespace std;
 
 bool GameWorld::getKey(int& value)
 {
+    if (m_controller == nullptr)
+    {
+        bool gotKey = m_hasScriptedKey;
+        if (gotKey)
+            value = m_scriptedKey;
+        m_hasScriptedKey = false;
+        return gotKey;
+    }
+
     bool gotKey = m_controller->getLastKey(value);
 
     if (gotKey)
@@ -18,10 +28,38 @@ bool GameWorld::getKey(int& value)
 
 void GameWorld::playSound(int soundID)
 {
-    m_controller->playSound(soundID);
+    m_soundEvents.push(soundID);
+}
+
+void GameWorld::setGameStatText(const string& text)
+{
+    if (m_controller != nullptr)
+        m_controller->setGameStatText(text);
 }
 
-void GameWorld::setGameStatText(string text)
+void GameWorld::setGameStatTextBuffer(const char* text)
 {
-    m_controller->setGameStatText(text);
+    if (m_controller != nullptr)
+        m_controller->setGameStatTextBuffer(text);
+}
+
+GameWorld::FastForwardResult GameWorld::fastForward(int ticks)
+{
+    using Clock = chrono::steady_clock;
+    FastForwardResult result;
+    Clock::time_point start = Clock::now();
+    m_fastForwarding = true;
+    bool soundsEnabled = m_soundEvents.isEnabled();
+    m_soundEvents.setEnabled(false);
+    while (result.ticks < ticks)
+    {
+        result.status = move();
+        result.ticks++;
+        if (result.status != GWSTATUS_CONTINUE_GAME)
+            break;
+    }
+    m_soundEvents.setEnabled(soundsEnabled);
+    m_fastForwarding = false;
+    result.seconds = chrono::duration<double>(Clock::now() - start).count();
+    return result;
 }
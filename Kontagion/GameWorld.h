@@ -2,11 +2,14 @@
 #define GAMEWORLD_H_
 
 #include "GameConstants.h"
+#include "SoundEventQueue.h"
 #include <string>
 
 const int START_PLAYER_LIVES = 3;
 
 class GameController;
+class StateHash;
+class MetricsExporter;
 
 class GameWorld
 {
@@ -14,7 +17,9 @@ public:
 
     GameWorld(std::string assetPath)
      : m_lives(START_PLAYER_LIVES), m_score(0), m_level(1),
-       m_controller(nullptr), m_assetPath(assetPath)
+       m_controller(nullptr), m_assetPath(assetPath),
+       m_scriptedKey(0), m_hasScriptedKey(false), m_fastForwarding(false),
+       m_metrics(nullptr)
     {
     }
 
@@ -26,9 +31,45 @@ public:
     virtual int move() = 0;
     virtual void cleanUp() = 0;
 
-    void setGameStatText(std::string text);
+      // What fastForward did
+    struct FastForwardResult
+    {
+        int    ticks = 0;                       // ticks run
+        int    status = GWSTATUS_CONTINUE_GAME; // what the last one returned
+        double seconds = 0;                     // wall time taken
+
+        double ticksPerSecond() const
+        {
+            return seconds > 0 ? ticks / seconds : 0;
+        }
+    };
+
+      // Run up to ticks calls of move() back to back, with no sounds queued
+      // and no status text generated, stopping early after a tick that
+      // doesn't return GWSTATUS_CONTINUE_GAME (the caller handles that
+      // status just as after a single move()).  Gameplay is the same as
+      // running those ticks normally.
+    FastForwardResult fastForward(int ticks);
+
+    bool isFastForwarding() const
+    {
+        return m_fastForwarding;
+    }
+
+      // Add state that isn't drawn (e.g., hit points) to a golden trace's
+      // per-tick hash
+    virtual void hashState(StateHash& /* hash */)
+    {
+    }
+
+    void setGameStatText(const std::string& text);
+      // Like setGameStatText, but the controller displays text in place
+      // instead of copying it, so text must stay valid (and may be updated
+      // in place) until the next call to either function.
+    void setGameStatTextBuffer(const char* text);
 
     bool getKey(int& value);
+      // Queues the sound; the framework plays it after move() returns
     void playSound(int soundID);
 
     int getLevel() const
@@ -82,6 +123,32 @@ public:
     {
         m_controller = controller;
     }
+
+      // Without a controller (headless runs), getKey returns the key
+      // pressed here, once
+    void pressKey(int value)
+    {
+        m_scriptedKey = value;
+        m_hasScriptedKey = true;
+    }
+
+      // Where the world publishes live metrics after each tick (nullptr,
+      // the default, for none)
+    void setMetrics(MetricsExporter* metrics)
+    {
+        m_metrics = metrics;
+    }
+
+    MetricsExporter* getMetrics() const
+    {
+        return m_metrics;
+    }
+
+      // Sounds queued by playSound during the current tick
+    SoundEventQueue& soundEvents()
+    {
+        return m_soundEvents;
+    }
     
 private:
     int m_lives;
@@ -89,6 +156,11 @@ private:
     int m_level;
     GameController* m_controller;
     std::string     m_assetPath;
+    SoundEventQueue m_soundEvents;
+    int             m_scriptedKey;
+    bool            m_hasScriptedKey;
+    bool            m_fastForwarding;
+    MetricsExporter* m_metrics;
 };
 
 #endif // GAMEWORLD_H_
@@ -0,0 +1,160 @@
+#include "GoldenTrace.h"
+#include "GameWorld.h"
+#include "GraphObject.h"
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+using namespace std;
+
+static const string TRACE_HEADER = "kontagion-golden-trace";
+
+static string hexHash(uint64_t hash)
+{
+    char buf[17];
+    snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(hash));
+    return buf;
+}
+
+static uint64_t hashWorld(GameWorld* gw, int status)
+{
+    StateHash hash;
+    GraphObject::drawAllObjects(
+        [&hash](int imageID, unsigned int, double x, double y, int angle, double)
+        {
+            hash.add(imageID);
+            hash.add(x);
+            hash.add(y);
+            hash.add(angle);
+            hash.endItem();
+        }
+    );
+    gw->hashState(hash);
+    hash.add(gw->getScore());
+    hash.add(gw->getLives());
+    hash.add(gw->getLevel());
+    hash.add(status);
+    hash.endItem();
+    return hash.value();
+}
+
+  // Play gw from a seeded start for up to ticks ticks, as GameController
+  // would, calling report(tick, hash) after each.  Stops at game over or
+  // when report returns false.  Returns the number of ticks played.
+static int playSeeded(GameWorld* gw, unsigned int seed, int ticks, const function<bool(int, uint64_t)>& report)
+{
+      // Keystrokes: mostly rotating, some sprays, a few flames
+    static const int script[] = {
+        KEY_PRESS_LEFT, KEY_PRESS_LEFT, KEY_PRESS_LEFT, KEY_PRESS_RIGHT, KEY_PRESS_RIGHT,
+        KEY_PRESS_SPACE, KEY_PRESS_SPACE, KEY_PRESS_ENTER, 0, 0
+    };
+    seedRandom(seed);
+    mt19937 keys(seed);
+    gw->soundEvents().setEnabled(false);     // nobody listens
+    gw->init();
+    int tick = 0;
+    while (tick < ticks)
+    {
+        int key = script[keys() % (sizeof(script) / sizeof(script[0]))];
+        if (key != 0)
+            gw->pressKey(key);
+        int status = gw->move();
+        bool keepGoing = report(tick, hashWorld(gw, status));
+        tick++;
+        if (!keepGoing)
+            break;
+        if (status == GWSTATUS_PLAYER_DIED)
+        {
+            if (gw->isGameOver())
+                break;
+            gw->cleanUp();
+            gw->init();
+        }
+        else if (status == GWSTATUS_FINISHED_LEVEL)
+        {
+            gw->advanceToNextLevel();
+            gw->cleanUp();
+            gw->init();
+        }
+        else if (status != GWSTATUS_CONTINUE_GAME)
+            break;
+    }
+    gw->cleanUp();
+    gw->soundEvents().setEnabled(true);
+    return tick;
+}
+
+int recordGoldenTrace(GameWorld* gw, const string& fileName, unsigned int seed, int ticks)
+{
+    ofstream out(fileName);
+    if (!out)
+    {
+        cerr << "Cannot write " << fileName << endl;
+        return 1;
+    }
+    out << TRACE_HEADER << " seed " << seed << " ticks " << ticks
+        << " dish " << dish().radius << ' ' << dish().density << '\n';
+    int played = playSeeded(gw, seed, ticks,
+        [&out](int tick, uint64_t hash)
+        {
+            out << tick << ' ' << hexHash(hash) << '\n';
+            return true;
+        }
+    );
+    if (!out)
+    {
+        cerr << "Cannot write " << fileName << endl;
+        return 1;
+    }
+    cout << "Recorded " << played << " ticks to " << fileName << endl;
+    return 0;
+}
+
+int checkGoldenTrace(GameWorld* gw, const string& fileName)
+{
+    ifstream in(fileName);
+    string header, seedLabel, ticksLabel, dishLabel;
+    unsigned int seed;
+    int ticks, radius;
+    double density;
+    if (!(in >> header >> seedLabel >> seed >> ticksLabel >> ticks >> dishLabel >> radius >> density)  ||
+        header != TRACE_HEADER)
+    {
+        cerr << fileName << " is not a golden trace" << endl;
+        return 1;
+    }
+    vector<uint64_t> expected;
+    int tick;
+    uint64_t hash;
+    while (in >> dec >> tick >> hex >> hash)
+        expected.push_back(hash);
+
+    setDishRadius(radius, density);
+    int divergedAt = -1;
+    uint64_t actual = 0;
+    int played = playSeeded(gw, seed, static_cast<int>(expected.size()),
+        [&](int t, uint64_t h)
+        {
+            if (h == expected[t])
+                return true;
+            divergedAt = t;
+            actual = h;
+            return false;
+        }
+    );
+    if (divergedAt >= 0)
+    {
+        cout << "Diverged from " << fileName << " at tick " << divergedAt << " (expected "
+             << hexHash(expected[divergedAt]) << ", got " << hexHash(actual) << ")" << endl;
+        return 1;
+    }
+    if (played < static_cast<int>(expected.size()))
+    {
+        cout << "Game ended after " << played << " ticks, but " << fileName << " has "
+             << expected.size() << endl;
+        return 1;
+    }
+    cout << "Matches " << fileName << " for all " << played << " ticks" << endl;
+    return 0;
+}
@@ -0,0 +1,90 @@
+#ifndef GOLDENTRACE_H_
+#define GOLDENTRACE_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class GameWorld;
+
+  // Golden traces check that a change to the simulation (or an optional
+  // mode such as --flame-bursts or a fixed-point build) plays exactly
+  // as the game did before.  recordGoldenTrace runs a seeded world
+  // headlessly, with scripted keystrokes, for a number of ticks and writes
+  // a hash of the whole world state after each tick; checkGoldenTrace
+  // replays the same run and reports the first tick whose hash differs.
+  //
+  // The state hashed each tick is every drawn sprite (image, position,
+  // direction), whatever GameWorld::hashState adds (hit points, Socrates'
+  // charges), and the score, lives, level, and tick status.  Items are
+  // hashed independently of the order they are listed in, so a mode that
+  // stores actors differently still matches as long as it plays the same.
+  //
+  // Reference traces (scripted keys, auto-play, and a large dish) are kept
+  // in GoldenTraces, and GoldenTraces/check.sh checks them all.
+
+  // Order-independent FNV-1a hash of a set of items, each a few numbers
+class StateHash
+{
+  public:
+
+    StateHash()
+     : m_item(FNV_OFFSET)
+    {
+    }
+
+    void add(int64_t value)
+    {
+        m_item ^= static_cast<uint64_t>(value);
+        m_item *= FNV_PRIME;
+    }
+
+      // Positions are compared to a millionth of a pixel
+    void add(double value)
+    {
+        add(static_cast<int64_t>(std::llround(value * 1e6)));
+    }
+
+    void add(int value)
+    {
+        add(static_cast<int64_t>(value));
+    }
+
+      // Finish the current item and start another
+    void endItem()
+    {
+        m_items.push_back(m_item);
+        m_item = FNV_OFFSET;
+    }
+
+    uint64_t value()
+    {
+        if (m_item != FNV_OFFSET)
+            endItem();
+        std::sort(m_items.begin(), m_items.end());
+        uint64_t h = FNV_OFFSET;
+        for (uint64_t item : m_items)
+        {
+            h ^= item;
+            h *= FNV_PRIME;
+        }
+        return h;
+    }
+
+  private:
+    static const uint64_t FNV_OFFSET = 1469598103934665603ULL;
+    static const uint64_t FNV_PRIME = 1099511628211ULL;
+
+    uint64_t              m_item;
+    std::vector<uint64_t> m_items;
+};
+
+  // Both return a process exit status (0 on success) after printing the
+  // outcome.  A trace records its seed, tick count, and dish size, and
+  // checkGoldenTrace replays with those.
+int recordGoldenTrace(GameWorld* gw, const std::string& fileName, unsigned int seed, int ticks);
+int checkGoldenTrace(GameWorld* gw, const std::string& fileName);
+
+#endif // GOLDENTRACE_H_
@@ -0,0 +1,56 @@
+#!/bin/sh
+  # Replays every reference golden trace in this directory and reports the
+  # first tick where the game no longer plays as it did when the trace was
+  # recorded.  Run it after any change to the simulation, and with the
+  # option of a mode that must play the same (e.g., --flame-bursts or
+  # --batched-bacteria):
+  #
+  #   Kontagion/GoldenTraces/check.sh [--fixed-point] [KONTAGION_BINARY [OPTION...]]
+  #
+  # The binary defaults to the Xcode Debug build.  Whichever binary it is,
+  # it runs from the Debug build's directory, where the Assets directory is.
+  # Each trace's header holds its seed, tick count, and dish size; traces
+  # named autoplay-* were recorded with --auto-play, which the check must
+  # pass too.
+  #
+  # The traces here come from the default (double) build.  Fixed-point
+  # positions round differently, so builds with KONTAGION_FIXED_POINT (the
+  # Xcode FixedPoint configuration) have their own traces in fixed-point/;
+  # --fixed-point checks those instead, with the FixedPoint build by
+  # default.  If a change is meant to alter play, re-record both sets the
+  # same way, each with its own build, e.g.,
+  #
+  #   Kontagion --golden-record keys-seed9.txt --seed 9 --golden-ticks 3000
+  #   Kontagion --golden-record autoplay-seed3.txt --seed 3 --golden-ticks 6000 --auto-play
+  #   Kontagion --golden-record autoplay-dish512-seed5.txt --seed 5 --golden-ticks 4000 --auto-play --dish-radius 512
+
+traceDir=$(cd "$(dirname "$0")" && pwd)
+productsDir="$traceDir/../../DerivedData/Kontagion/Build/Products"
+runDir="$productsDir/Debug"
+defaultBinary="$productsDir/Debug/Kontagion"
+if [ "$1" = "--fixed-point" ]; then
+    shift
+    traceDir="$traceDir/fixed-point"
+    defaultBinary="$productsDir/FixedPoint/Kontagion"
+fi
+binary=${1:-"$defaultBinary"}
+[ $# -gt 0 ] && shift
+
+if [ ! -x "$binary" ]; then
+    echo "Cannot find the Kontagion binary $binary" >&2
+    exit 2
+fi
+binary="$(cd "$(dirname "$binary")" && pwd)/$(basename "$binary")"
+
+failed=0
+for trace in "$traceDir"/*.txt; do
+    case $(basename "$trace") in
+      autoplay-*)  flags=--auto-play ;;
+      *)           flags= ;;
+    esac
+    printf '%s: ' "$(basename "$trace")"
+    if ! (cd "$runDir" && "$binary" --golden-check "$trace" $flags "$@"); then
+        failed=1
+    fi
+done
+exit $failed
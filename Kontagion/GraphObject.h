@@ -3,9 +3,12 @@
 
 #include "SpriteManager.h"
 #include "GameConstants.h"
+#include "Coord.h"
 
 #include <set>
+#include <vector>
 #include <cmath>
+#include <cstdint>
 
 const int ANIMATION_POSITIONS_PER_TICK = 1;
 
@@ -21,8 +24,9 @@ class GraphObject
     static const int down = 270;
 
     GraphObject(int imageID, double startX, double startY, Direction dir = 0, int depth = 0, double size = 1.0)
-     : m_imageID(imageID), m_x(startX), m_y(startY), m_destX(startX), m_destY(startY),
-       m_animationNumber(0), m_direction(dir), m_depth(depth), m_size(size)
+     : m_destX(startX), m_destY(startY), m_animationPhase(nextAnimationPhase()++), m_size(static_cast<float>(size)),
+       m_imageID(static_cast<int16_t>(imageID)), m_direction(static_cast<int16_t>(dir)), m_depth(static_cast<uint8_t>(depth)),
+       m_visible(true), m_static(false)
     {
         if (m_size <= 0)
             m_size = 1;
@@ -33,6 +37,7 @@ class GraphObject
     virtual ~GraphObject()
     {
         getGraphObjects(m_depth).erase(this);
+        staticChanged();
     }
 
     double getX() const
@@ -47,28 +52,40 @@ class GraphObject
         return m_destY;
     }
 
+      // Same as getX/getY, without converting from fixed point
+    Coord getCoordX() const
+    {
+        return m_destX;
+    }
+
+    Coord getCoordY() const
+    {
+        return m_destY;
+    }
+
     virtual void moveTo(double x, double y)
     {
         m_destX = x;
         m_destY = y;
-        increaseAnimationNumber();
+        staticChanged();
     }
 
     virtual void moveAngle(Direction angle, int units = 1)
     {
-    	const double PI = 4 * atan(1);
-    	double newX = (getX() + units * cos(angle*1.0 / 360 * 2 * PI));
-    	double newY = (getY() + units * sin(angle*1.0 / 360 * 2 * PI));
+    	Coord newX = m_destX;
+    	Coord newY = m_destY;
+    	advanceCoords(newX, newY, angle, units);
 
     	moveTo(newX, newY);
-    	increaseAnimationNumber();
     }
 
     virtual void getPositionInThisDirection(Direction angle, int units, double &dx, double &dy)
     {
-    	const double PI = 4 * atan(1);
-    	dx = (getX() + units * cos(angle*1.0 / 360 * 2 * PI));
-    	dy = (getY() + units * sin(angle*1.0 / 360 * 2 * PI));
+    	Coord newX = m_destX;
+    	Coord newY = m_destY;
+    	advanceCoords(newX, newY, angle, units);
+    	dx = newX;
+    	dy = newY;
     }
 
     void moveForward(int units = 1)
@@ -86,12 +103,19 @@ class GraphObject
         while (d < 0)
             d += 360;
 
-        m_direction = d % 360;
+        m_direction = static_cast<int16_t>(d % 360);
+        staticChanged();
+    }
+
+    int getImageID() const
+    {
+        return m_imageID;
     }
 
     void setSize(double size)
     {
-        m_size = size;
+        m_size = static_cast<float>(size);
+        staticChanged();
     }
 
     double getSize() const
@@ -99,60 +123,239 @@ class GraphObject
         return m_size;
     }
 
+    void setVisible(bool shouldIDisplay)
+    {
+        m_visible = shouldIDisplay;
+        staticChanged();
+    }
+
+      // Promise that this object will rarely if ever move, turn, resize,
+      // or change visibility, and that its image has a single frame, so it
+      // may be drawn from a cached layer of static sprites.  Any such
+      // change (or destroying the object) still shows up; it just costs a
+      // redraw of the whole cached layer.
+    void setStatic(bool isStatic)
+    {
+        m_static = isStatic;
+        staticLayerVersion()++;
+    }
+
       // The following should be used by only the framework, not the student
 
+      // Sprites animate with time rather than with movement: the frame
+      // shown is (animation tick + the object's phase) modulo the image's
+      // frame count.  Each object gets its own phase so that objects of
+      // the same kind don't all change frames in lockstep.
     void increaseAnimationNumber()
     {
-        m_animationNumber++;
+        m_animationPhase++;
+        staticChanged();
+    }
+
+    static void advanceAnimationTick()
+    {
+        animationTick()++;
     }
 
+      // Many identical sprites that never move or animate (e.g., dirt) can
+      // be drawn from a SpriteBatch instead of being GraphObjects of their
+      // own.  A batch is drawn along with the GraphObjects at its depth,
+      // just before them.
+    class SpriteBatch
+    {
+      public:
+        SpriteBatch(int imageID, Direction dir = 0, int depth = 0, double size = 1.0)
+         : m_imageID(imageID), m_direction(dir), m_depth(depth), m_size(size), m_static(false)
+        {
+            getBatches(m_depth).insert(this);
+        }
+
+        ~SpriteBatch()
+        {
+            getBatches(m_depth).erase(this);
+            staticChanged();
+        }
+
+        void add(double x, double y)
+        {
+            m_positions.push_back(Position{ x, y, m_direction });
+            staticChanged();
+        }
+
+        void add(double x, double y, Direction dir)
+        {
+            m_positions.push_back(Position{ x, y, dir });
+            staticChanged();
+        }
+
+        void clear()
+        {
+            m_positions.clear();
+            staticChanged();
+        }
+
+          // As for GraphObject::setStatic: the batch's sprites may be drawn
+          // from the cached static layer, which is redrawn whenever the
+          // batch changes
+        void setStatic(bool isStatic)
+        {
+            m_static = isStatic;
+            staticLayerVersion()++;
+        }
+
+        size_t size() const
+        {
+            return m_positions.size();
+        }
+
+          // Prevent copying or assigning SpriteBatches
+        SpriteBatch(const SpriteBatch&) = delete;
+        SpriteBatch& operator=(const SpriteBatch&) = delete;
+
+      private:
+        friend class GraphObject;
+
+        struct Position
+        {
+            double      x;
+            double      y;
+            Direction   direction;
+        };
+
+        int     m_imageID;
+        Direction   m_direction;
+        int     m_depth;
+        double  m_size;
+        bool    m_static;
+        std::vector<Position> m_positions;
+
+        void staticChanged()
+        {
+            if (m_static)
+                staticLayerVersion()++;
+        }
+
+        static std::set<SpriteBatch*>& getBatches(int depth)
+        {
+            static std::set<SpriteBatch*> batches[NUM_DEPTHS];
+            if (depth < NUM_DEPTHS)
+                return batches[depth];
+            else
+                return batches[0];
+        }
+    };
+
     template<typename Func>
     static void drawAllObjects(Func plotFunc)
+    {
+        drawObjects(plotFunc, true, true);
+    }
+
+      // Draw only the static objects and batches (see setStatic), or only
+      // the others.  Drawing the static ones and then the dynamic ones
+      // puts every sprite on screen, in the same order as drawAllObjects
+      // except that static sprites are beneath everything else.
+    template<typename Func>
+    static void drawStaticObjects(Func plotFunc)
+    {
+        drawObjects(plotFunc, true, false);
+    }
+
+    template<typename Func>
+    static void drawDynamicObjects(Func plotFunc)
+    {
+        drawObjects(plotFunc, false, true);
+    }
+
+      // Changes whenever what drawStaticObjects would draw may have changed
+    static unsigned long getStaticLayerVersion()
+    {
+        return staticLayerVersion();
+    }
+
+      // Approximate heap bytes the registry of GraphObjects uses for each
+      // one: a std::set node, i.e., a color word and three links plus the
+      // pointer itself
+    static const size_t REGISTRY_NODE_BYTES = 4 * sizeof(void*) + sizeof(GraphObject*);
+
+      // Number of GraphObjects in existence
+    static size_t registeredCount()
+    {
+        size_t n = 0;
+        for (int depth = 0; depth < NUM_DEPTHS; depth++)
+            n += getGraphObjects(depth).size();
+        return n;
+    }
+
+      // Prevent copying or assigning GraphObjects
+    GraphObject(const GraphObject&) = delete;
+    GraphObject& operator=(const GraphObject&) = delete;
+
+  private:
+
+    static const int NUM_DEPTHS = 4;
+
+      // Kept small so a whole Actor (these, the vtable pointer, and the
+      // Actor's own few fields) fits in a 64-byte cache line.  Objects are
+      // drawn where they are (animate used to copy the destination into a
+      // second, drawn position every frame), a direction is a degree from
+      // 0 to 359, a depth is below NUM_DEPTHS, and sprite scales are
+      // simple fractions a float holds exactly.
+    Coord   m_destX;
+    Coord   m_destY;
+    unsigned int    m_animationPhase;
+    float   m_size;
+    int16_t m_imageID;
+    int16_t m_direction;
+    uint8_t m_depth;
+    bool    m_visible;
+    bool    m_static;
+
+    template<typename Func>
+    static void drawObjects(Func plotFunc, bool drawStatic, bool drawDynamic)
     {
         for (int depth = NUM_DEPTHS - 1; depth >= 0; depth--)
         {
+            for (SpriteBatch* batch : SpriteBatch::getBatches(depth))
+            {
+                if (batch->m_static ? !drawStatic : !drawDynamic)
+                    continue;
+                for (const SpriteBatch::Position& p : batch->m_positions)
+                    plotFunc(batch->m_imageID, animationTick(), p.x, p.y, p.direction, batch->m_size);
+            }
             for (GraphObject* go : getGraphObjects(depth))
             {
-                go->animate();
-                plotFunc(go->m_imageID, go->m_animationNumber, go->m_x, go->m_y, go->m_direction, go->m_size);
+                if (go->m_static ? !drawStatic : !drawDynamic)
+                    continue;
+                if (!go->m_visible)
+                    continue;
+                plotFunc(go->m_imageID, animationTick() + go->m_animationPhase, go->m_destX, go->m_destY, go->m_direction, go->m_size);
             }
         }
     }
 
-      // Prevent copying or assigning GraphObjects
-    GraphObject(const GraphObject&) = delete;
-    GraphObject& operator=(const GraphObject&) = delete;
+    void staticChanged()
+    {
+        if (m_static)
+            staticLayerVersion()++;
+    }
 
-  private:
+    static unsigned int& animationTick()
+    {
+        static unsigned int tick = 0;
+        return tick;
+    }
 
-    static const int NUM_DEPTHS = 4;
-    int     m_imageID;
-    double  m_x;
-    double  m_y;
-    double  m_destX;
-    double  m_destY;
-    int     m_animationNumber;
-    Direction   m_direction;
-    int     m_depth;
-    double  m_size;
-
-    void animate()
-    {
-        m_x = m_destX;
-        m_y = m_destY;
-        //moveALittle(m_x, m_destX);
-        //moveALittle(m_y, m_destY);
-    }
-
-    void moveALittle(double& from, double& to)
-    {
-        static const double DISTANCE = 1.0/ANIMATION_POSITIONS_PER_TICK;
-        if (to - from >= DISTANCE)
-            from += DISTANCE;
-        else if (from - to >= DISTANCE)
-            from -= DISTANCE;
-        else
-            from = to;
+    static unsigned long& staticLayerVersion()
+    {
+        static unsigned long version = 1;
+        return version;
+    }
+
+    static unsigned int& nextAnimationPhase()
+    {
+        static unsigned int phase = 0;
+        return phase;
     }
 
     static std::set<GraphObject*>& getGraphObjects(int depth)
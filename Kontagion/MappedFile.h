@@ -0,0 +1,108 @@
+#ifndef MAPPEDFILE_H_
+#define MAPPEDFILE_H_
+
+#include <cstddef>
+#include <string>
+
+#ifdef _MSC_VER
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+  // A read-only view of a whole file, mapped into memory instead of read
+  // through a stream, so its bytes can be handed straight to whoever
+  // consumes them without being copied into a buffer first.  The view
+  // stays valid until the MappedFile is destroyed or closed.
+
+class MappedFile
+{
+  public:
+
+    MappedFile()
+     : m_data(nullptr), m_size(0)
+    {
+    }
+
+    ~MappedFile()
+    {
+        close();
+    }
+
+      // Map fileName; returns false (leaving nothing mapped) if the file
+      // can't be opened or is empty.
+    bool open(const std::string& fileName)
+    {
+        close();
+#ifdef _MSC_VER
+        HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+        LARGE_INTEGER size;
+        HANDLE mapping = nullptr;
+        if (GetFileSizeEx(file, &size)  &&  size.QuadPart > 0)
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (mapping == nullptr)
+            return false;
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);   // the view keeps the mapping alive
+        if (view == nullptr)
+            return false;
+        m_size = static_cast<size_t>(size.QuadPart);
+#else
+        int fd = ::open(fileName.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat info;
+        void* view = MAP_FAILED;
+        if (fstat(fd, &info) == 0  &&  info.st_size > 0)
+            view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);            // the mapping keeps the file alive
+        if (view == MAP_FAILED)
+            return false;
+        m_size = static_cast<size_t>(info.st_size);
+#endif
+        m_data = static_cast<const unsigned char*>(view);
+        return true;
+    }
+
+    void close()
+    {
+        if (m_data == nullptr)
+            return;
+#ifdef _MSC_VER
+        UnmapViewOfFile(m_data);
+#else
+        munmap(const_cast<unsigned char*>(m_data), m_size);
+#endif
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    const unsigned char* data() const
+    {
+        return m_data;
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+      // Prevent copying or assigning MappedFiles
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+  private:
+    const unsigned char* m_data;
+    size_t               m_size;
+};
+
+#endif // MAPPEDFILE_H_
@@ -0,0 +1,216 @@
+#include "MetricsExporter.h"
+#include "GameConstants.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <type_traits>
+using namespace std;
+
+static_assert(is_trivially_copyable<WorldMetrics>::value  &&  sizeof(WorldMetrics) % sizeof(int64_t) == 0,
+              "WorldMetrics is published as an array of int64_t words");
+
+namespace
+{
+    const char* imageName(int imageID)
+    {
+        switch (imageID)
+        {
+          case IID_PLAYER:                return "socrates";
+          case IID_SALMONELLA:            return "salmonella";
+          case IID_FOOD:                  return "food";
+          case IID_ECOLI:                 return "ecoli";
+          case IID_SPRAY:                 return "spray";
+          case IID_FLAME:                 return "flame";
+          case IID_PIT:                   return "pit";
+          case IID_DIRT:                  return "dirt";
+          case IID_FLAME_THROWER_GOODIE:  return "flame_thrower_goodie";
+          case IID_RESTORE_HEALTH_GOODIE: return "restore_health_goodie";
+          case IID_EXTRA_LIFE_GOODIE:     return "extra_life_goodie";
+          case IID_FUNGUS:                return "fungus";
+          default:                        return nullptr;
+        }
+    }
+
+    void writeHeader(ostream& out, const char* name, const char* type, const char* help)
+    {
+        out << "# HELP " << name << ' ' << help << '\n'
+            << "# TYPE " << name << ' ' << type << '\n';
+    }
+}
+
+void WorldMetrics::addTickLatency(int64_t ns)
+{
+    int bucket = 0;
+    for (int64_t limit = 1000; bucket < LATENCY_BUCKETS - 1  &&  ns >= limit; limit *= 2)
+        bucket++;
+    latency[bucket]++;
+    latencyTotalNs += ns;
+}
+
+MetricsExporter::MetricsExporter(const string& fileName, int intervalMs)
+ : m_fileName(fileName), m_interval(intervalMs > 0 ? intervalMs : 1000),
+   m_sequence(0), m_stopping(false)
+{
+    for (atomic<int64_t>& w : m_words)
+        w.store(0, memory_order_relaxed);
+    publish(WorldMetrics());
+}
+
+MetricsExporter::~MetricsExporter()
+{
+    if (m_thread.joinable())
+    {
+        {
+            lock_guard<mutex> lock(m_stopMutex);
+            m_stopping = true;
+        }
+        m_stopCondition.notify_one();
+        m_thread.join();
+    }
+}
+
+void MetricsExporter::start()
+{
+    if (!m_thread.joinable())
+        m_thread = thread(&MetricsExporter::run, this);
+}
+
+void MetricsExporter::publish(const WorldMetrics& metrics)
+{
+    int64_t words[NUM_WORDS];
+    memcpy(words, &metrics, sizeof(words));
+    uint64_t seq = m_sequence.load(memory_order_relaxed);
+    m_sequence.store(seq + 1, memory_order_relaxed);    // odd: being written
+    atomic_thread_fence(memory_order_release);
+    for (size_t i = 0; i < NUM_WORDS; i++)
+        m_words[i].store(words[i], memory_order_relaxed);
+    m_sequence.store(seq + 2, memory_order_release);
+}
+
+WorldMetrics MetricsExporter::read() const
+{
+    int64_t words[NUM_WORDS];
+    for (;;)
+    {
+        uint64_t before = m_sequence.load(memory_order_acquire);
+        if (before & 1)
+        {
+            this_thread::yield();
+            continue;
+        }
+        for (size_t i = 0; i < NUM_WORDS; i++)
+            words[i] = m_words[i].load(memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        if (m_sequence.load(memory_order_relaxed) == before)
+            break;
+    }
+    WorldMetrics metrics;
+    memcpy(&metrics, words, sizeof(words));
+    return metrics;
+}
+
+void MetricsExporter::run()
+{
+    using Clock = chrono::steady_clock;
+    WorldMetrics prev = read();
+    Clock::time_point prevTime = Clock::now();
+    bool stopping = false;
+    while (!stopping)
+    {
+        {
+            unique_lock<mutex> lock(m_stopMutex);
+            m_stopCondition.wait_for(lock, m_interval, [this] { return m_stopping; });
+            stopping = m_stopping;
+        }
+        WorldMetrics snapshot = read();
+        Clock::time_point now = Clock::now();
+        double seconds = chrono::duration<double>(now - prevTime).count();
+        if (!writeFile(snapshot, prev, seconds))
+            return;
+        prev = snapshot;
+        prevTime = now;
+    }
+}
+
+  // Write to a temporary file and rename it over fileName, so a scraper
+  // never sees a partly written file
+bool MetricsExporter::writeFile(const WorldMetrics& snapshot, const WorldMetrics& prev, double seconds)
+{
+    string tempName = m_fileName + ".tmp";
+    {
+        ofstream out(tempName);
+        if (out)
+            writeText(out, snapshot, prev, seconds);
+        if (!out)
+        {
+            cerr << "Cannot write metrics to " << tempName << endl;
+            return false;
+        }
+    }
+#ifdef _MSC_VER
+    remove(m_fileName.c_str());     // rename won't replace an existing file
+#endif
+    if (rename(tempName.c_str(), m_fileName.c_str()) != 0)
+    {
+        cerr << "Cannot write metrics to " << m_fileName << endl;
+        return false;
+    }
+    return true;
+}
+
+void MetricsExporter::writeText(ostream& out, const WorldMetrics& snapshot,
+                                const WorldMetrics& prev, double seconds)
+{
+    int64_t ticks = snapshot.tick - prev.tick;
+
+    writeHeader(out, "kontagion_ticks", "counter", "Ticks played.");
+    out << "kontagion_ticks " << snapshot.tick << '\n';
+    writeHeader(out, "kontagion_ticks_per_second", "gauge", "Ticks played per second since the previous write.");
+    out << "kontagion_ticks_per_second " << (seconds > 0 ? ticks / seconds : 0) << '\n';
+    writeHeader(out, "kontagion_level", "gauge", "Current level.");
+    out << "kontagion_level " << snapshot.level << '\n';
+    writeHeader(out, "kontagion_score", "gauge", "Current score.");
+    out << "kontagion_score " << snapshot.score << '\n';
+    writeHeader(out, "kontagion_lives", "gauge", "Lives left.");
+    out << "kontagion_lives " << snapshot.lives << '\n';
+
+    writeHeader(out, "kontagion_actors", "gauge", "Live actors by type.");
+    for (int id = 0; id < WorldMetrics::MAX_IMAGE_IDS; id++)
+    {
+        const char* name = imageName(id);
+        if (name != nullptr)
+            out << "kontagion_actors{type=\"" << name << "\"} " << snapshot.actors[id] << '\n';
+    }
+    writeHeader(out, "kontagion_swept_projectiles", "gauge", "Live swept sprays and flames.");
+    out << "kontagion_swept_projectiles " << snapshot.projectiles << '\n';
+    writeHeader(out, "kontagion_actor_vector_size", "gauge", "Size of the world's actor vector.");
+    out << "kontagion_actor_vector_size " << snapshot.actorVectorSize << '\n';
+    writeHeader(out, "kontagion_actor_vector_capacity", "gauge", "Capacity of the world's actor vector.");
+    out << "kontagion_actor_vector_capacity " << snapshot.actorVectorCapacity << '\n';
+
+    writeHeader(out, "kontagion_actor_vector_growths", "counter", "Times the world's actor vector has reallocated.");
+    out << "kontagion_actor_vector_growths " << snapshot.actorVectorGrowths << '\n';
+    writeHeader(out, "kontagion_actor_bytes", "gauge", "Memory used by live actors (objects and registry nodes).");
+    out << "kontagion_actor_bytes " << snapshot.actorBytes << '\n';
+    writeHeader(out, "kontagion_actor_peak_bytes", "gauge", "Most memory used by actors at once this level.");
+    out << "kontagion_actor_peak_bytes " << snapshot.peakActorBytes << '\n';
+
+    writeHeader(out, "kontagion_allocations", "counter", "Heap allocations by the world (actors and actor vector growth).");
+    out << "kontagion_allocations " << snapshot.allocations << '\n';
+    writeHeader(out, "kontagion_allocations_per_tick", "gauge", "Allocations per tick since the previous write.");
+    out << "kontagion_allocations_per_tick "
+        << (ticks > 0 ? double(snapshot.allocations - prev.allocations) / ticks : 0) << '\n';
+
+    writeHeader(out, "kontagion_tick_seconds", "histogram", "Time taken by each tick.");
+    int64_t cumulative = 0;
+    for (int b = 0; b < WorldMetrics::LATENCY_BUCKETS - 1; b++)
+    {
+        cumulative += snapshot.latency[b];
+        out << "kontagion_tick_seconds_bucket{le=\"" << (1e-6 * (int64_t(1) << b)) << "\"} " << cumulative << '\n';
+    }
+    cumulative += snapshot.latency[WorldMetrics::LATENCY_BUCKETS - 1];
+    out << "kontagion_tick_seconds_bucket{le=\"+Inf\"} " << cumulative << '\n'
+        << "kontagion_tick_seconds_sum " << snapshot.latencyTotalNs / 1e9 << '\n'
+        << "kontagion_tick_seconds_count " << cumulative << '\n';
+}
@@ -0,0 +1,94 @@
+#ifndef METRICSEXPORTER_H_
+#define METRICSEXPORTER_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <thread>
+
+  // Live metrics for watching a long-running world (e.g., a soak test).
+  // The world fills in a WorldMetrics at the end of each tick and publishes
+  // it; a background thread reads the latest one every so often and
+  // rewrites a file in the Prometheus text format, which a textfile
+  // collector (or just `watch cat FILE`) can serve.
+  //
+  // Publishing is a seqlock: the tick thread bumps a sequence number,
+  // stores the snapshot word by word, and bumps the number again, so it
+  // never waits on the exporter.  A reader retries if the number was odd
+  // or changed while it copied.
+
+struct WorldMetrics
+{
+    static const int MAX_IMAGE_IDS = 16;
+      // Bucket b counts ticks that took under 2^b microseconds (the last
+      // bucket counts the rest)
+    static const int LATENCY_BUCKETS = 20;
+
+    int64_t tick = 0;                          // ticks played (across levels)
+    int64_t level = 0;
+    int64_t score = 0;
+    int64_t lives = 0;
+    int64_t actors[MAX_IMAGE_IDS] = {};        // live actors by image ID (including dirt)
+    int64_t projectiles = 0;                   // swept projectiles (not actors)
+    int64_t actorVectorSize = 0;               // m_actors.size()
+    int64_t actorVectorCapacity = 0;           // m_actors.capacity()
+    int64_t actorVectorGrowths = 0;            // times m_actors has reallocated
+    int64_t actorBytes = 0;                    // memory used by live actors
+    int64_t peakActorBytes = 0;                // most used at once this level
+    int64_t allocations = 0;                   // heap allocations by the world so far
+    int64_t latency[LATENCY_BUCKETS] = {};     // ticks so far by duration
+    int64_t latencyTotalNs = 0;                // time spent in those ticks
+
+      // Count a tick that took ns nanoseconds in the latency histogram
+    void addTickLatency(int64_t ns);
+};
+
+class MetricsExporter
+{
+  public:
+
+      // Rewrite fileName every intervalMs milliseconds once started
+    MetricsExporter(const std::string& fileName, int intervalMs);
+
+      // Stops the exporter thread after a last write
+    ~MetricsExporter();
+
+    void start();
+
+      // Called by the tick thread only
+    void publish(const WorldMetrics& metrics);
+
+      // The latest published snapshot (safe from any thread)
+    WorldMetrics read() const;
+
+      // Write snapshot in the Prometheus text format.  Rates are averaged
+      // since the previous snapshot (prev), which took seconds before it.
+    static void writeText(std::ostream& out, const WorldMetrics& snapshot,
+                          const WorldMetrics& prev, double seconds);
+
+      // Prevent copying or assigning MetricsExporters
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+  private:
+
+    static const size_t NUM_WORDS = sizeof(WorldMetrics) / sizeof(int64_t);
+
+    std::string             m_fileName;
+    std::chrono::milliseconds m_interval;
+    std::atomic<uint64_t>   m_sequence;
+    std::atomic<int64_t>    m_words[NUM_WORDS];
+    std::thread             m_thread;
+    std::mutex              m_stopMutex;    // exporter thread and destructor only
+    std::condition_variable m_stopCondition;
+    bool                    m_stopping;
+
+    void run();
+    bool writeFile(const WorldMetrics& snapshot, const WorldMetrics& prev, double seconds);
+};
+
+#endif // METRICSEXPORTER_H_
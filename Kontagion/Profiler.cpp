@@ -0,0 +1,187 @@
+#include "Profiler.h"
+#include <atomic>
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+namespace
+{
+    enum EventKind { SCOPE_EVENT, COUNTER_EVENT };
+
+    struct ProfileEvent
+    {
+        const char* name;
+        int64_t     startNs;
+        int64_t     value;   // duration in ns for scopes, count for counters
+        EventKind   kind;
+    };
+
+    const size_t RING_SIZE = 1 << 16;   // per thread; must be a power of 2
+
+    struct ProfileRing
+    {
+        ProfileEvent          events[RING_SIZE];
+        atomic<uint64_t>      head{0};  // total events ever written
+        long                  counters[Profiler::NUM_COUNTERS] = {};
+        int                   threadIndex = 0;
+        ProfileRing*          next = nullptr;
+    };
+
+    const Profiler::Clock::time_point epoch = Profiler::Clock::now();
+    atomic<ProfileRing*> allRings{nullptr};
+    atomic<int> nextThreadIndex{0};
+
+    int64_t sinceEpoch(Profiler::Clock::time_point t)
+    {
+        return chrono::duration_cast<chrono::nanoseconds>(t - epoch).count();
+    }
+
+      // Rings are never freed, so a dump still sees threads that have exited
+    ProfileRing& threadRing()
+    {
+        thread_local ProfileRing* ring = nullptr;
+        if (ring == nullptr)
+        {
+            ring = new ProfileRing;
+            ring->threadIndex = nextThreadIndex++;
+            ProfileRing* head = allRings.load();
+            do
+                ring->next = head;
+            while (!allRings.compare_exchange_weak(head, ring));
+        }
+        return *ring;
+    }
+
+    void record(ProfileRing& ring, const char* name, int64_t startNs, int64_t value, EventKind kind)
+    {
+        uint64_t h = ring.head.load(memory_order_relaxed);
+        ring.events[h & (RING_SIZE - 1)] = ProfileEvent{ name, startNs, value, kind };
+        ring.head.store(h + 1, memory_order_release);
+    }
+
+      // Copy out whatever each ring still holds, oldest first
+    template<typename Func>
+    void forEachEvent(Func f)
+    {
+        for (ProfileRing* ring = allRings.load(); ring != nullptr; ring = ring->next)
+        {
+            uint64_t end = ring->head.load(memory_order_acquire);
+            uint64_t begin = (end > RING_SIZE ? end - RING_SIZE : 0);
+            for (uint64_t i = begin; i < end; i++)
+                f(ring->threadIndex, ring->events[i & (RING_SIZE - 1)]);
+        }
+    }
+
+    void writeJsonString(ostream& out, const char* s)
+    {
+        out << '"';
+        for ( ; *s != '\0'; s++)
+        {
+            if (*s == '"'  ||  *s == '\\')
+                out << '\\';
+            out << *s;
+        }
+        out << '"';
+    }
+}
+
+bool Profiler::enabled()
+{
+#ifdef KONTAGION_PROFILE
+    return true;
+#else
+    return false;
+#endif
+}
+
+const char* Profiler::counterName(Counter c)
+{
+    static const char* const names[NUM_COUNTERS] = {
+        "queries", "candidates scanned", "actors spawned", "actors destroyed"
+    };
+    return (c >= 0  &&  c < NUM_COUNTERS ? names[c] : "?");
+}
+
+void Profiler::recordScope(const char* name, Clock::time_point start, Clock::time_point end)
+{
+    int64_t startNs = sinceEpoch(start);
+    record(threadRing(), name, startNs, sinceEpoch(end) - startNs, SCOPE_EVENT);
+}
+
+void Profiler::count(Counter c, long n)
+{
+    threadRing().counters[c] += n;
+}
+
+void Profiler::endTick()
+{
+    ProfileRing& ring = threadRing();
+    int64_t now = sinceEpoch(Clock::now());
+    for (int c = 0; c < NUM_COUNTERS; c++)
+    {
+        record(ring, counterName(Counter(c)), now, ring.counters[c], COUNTER_EVENT);
+        ring.counters[c] = 0;
+    }
+}
+
+void Profiler::writeChromeTrace(ostream& out)
+{
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    forEachEvent([&](int tid, const ProfileEvent& e)
+    {
+        out << (first ? "\n" : ",\n");
+        first = false;
+        out << "{\"name\":";
+        writeJsonString(out, e.name);
+        out << ",\"pid\":1,\"tid\":" << tid << ",\"ts\":" << e.startNs / 1000.0;
+        if (e.kind == SCOPE_EVENT)
+            out << ",\"ph\":\"X\",\"dur\":" << e.value / 1000.0 << "}";
+        else
+            out << ",\"ph\":\"C\",\"args\":{\"value\":" << e.value << "}}";
+    });
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+void Profiler::writeSummary(ostream& out)
+{
+    struct Totals
+    {
+        long    n = 0;
+        int64_t total = 0;
+        int64_t max = 0;
+    };
+    map<string, Totals> scopes;
+    map<string, Totals> counters;
+    forEachEvent([&](int, const ProfileEvent& e)
+    {
+        Totals& t = (e.kind == SCOPE_EVENT ? scopes : counters)[e.name];
+        t.n++;
+        t.total += e.value;
+        t.max = max(t.max, e.value);
+    });
+
+    out << fixed << setprecision(2);
+    out << left << setw(36) << "scope" << right << setw(10) << "calls"
+        << setw(12) << "total ms" << setw(12) << "mean us" << setw(12) << "max us" << '\n';
+    for (const auto& s : scopes)
+    {
+        const Totals& t = s.second;
+        out << left << setw(36) << s.first << right << setw(10) << t.n
+            << setw(12) << t.total / 1e6 << setw(12) << t.total / 1e3 / t.n
+            << setw(12) << t.max / 1e3 << '\n';
+    }
+    out << '\n' << left << setw(36) << "counter" << right << setw(10) << "ticks"
+        << setw(12) << "total" << setw(12) << "per tick" << setw(12) << "max" << '\n';
+    for (const auto& c : counters)
+    {
+        const Totals& t = c.second;
+        out << left << setw(36) << c.first << right << setw(10) << t.n
+            << setw(12) << t.total << setw(12) << double(t.total) / t.n
+            << setw(12) << t.max << '\n';
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+
+// Per-tick profiling.  Everything here compiles away to nothing unless the
+// build defines KONTAGION_PROFILE, so the macros can stay in hot paths.
+//
+//   PROFILE_SCOPE("name")        time the enclosing block
+//   PROFILE_COUNT(counter, n)    add n to one of the Profiler::Counter totals
+//   PROFILE_TICK()               mark a tick boundary: the counters gathered
+//                                since the previous boundary become one sample
+//
+// Each thread records into its own fixed-size ring buffer, which only that
+// thread writes, so recording never takes a lock.  When a ring wraps, the
+// oldest events are overwritten.  Dump the results with writeChromeTrace()
+// (load the file in chrome://tracing) or writeSummary().
+
+class Profiler
+{
+  public:
+
+    enum Counter
+    {
+        QUERIES,             // neighbor queries issued
+        CANDIDATES_SCANNED,  // actors examined by those queries
+        ACTORS_SPAWNED,
+        ACTORS_DESTROYED,
+        NUM_COUNTERS
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    static bool enabled();
+
+    static void recordScope(const char* name, Clock::time_point start, Clock::time_point end);
+    static void count(Counter c, long n);
+    static void endTick();
+
+    static void writeChromeTrace(std::ostream& out);
+    static void writeSummary(std::ostream& out);
+
+    static const char* counterName(Counter c);
+};
+
+class ProfileScope
+{
+  public:
+    explicit ProfileScope(const char* name)
+     : m_name(name), m_start(Profiler::Clock::now())
+    {
+    }
+
+    ~ProfileScope()
+    {
+        Profiler::recordScope(m_name, m_start, Profiler::Clock::now());
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+  private:
+    const char*                 m_name;
+    Profiler::Clock::time_point m_start;
+};
+
+#ifdef KONTAGION_PROFILE
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#define PROFILE_COUNT(counter, n) Profiler::count(Profiler::counter, (n))
+#define PROFILE_TICK() Profiler::endTick()
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_COUNT(counter, n) ((void)0)
+#define PROFILE_TICK() ((void)0)
+#endif
+
+#endif // PROFILER_H_
@@ -0,0 +1,116 @@
+#ifndef PROJECTILESYSTEM_H_
+#define PROJECTILESYSTEM_H_
+
+#include "GraphObject.h"
+#include <cmath>
+#include <vector>
+
+//////////
+// ProjectileSystem class declaration
+//////////
+
+// All live sprays and flames when GameOptions::sweptProjectiles is on, stored as parallel arrays instead of Projectile actors.
+// StudentWorld steps them all once per tick: each projectile checks the whole segment it covered since the last tick
+// (one query per projectile), so nothing can slip between two of its positions, then moves forward.
+// Sprays and flames are drawn as one SpriteBatch each.
+
+class ProjectileSystem
+{
+public:
+    ProjectileSystem() : m_flameSprites(IID_FLAME, 0, 1), m_spraySprites(IID_SPRAY, 0, 1) {}
+    void add(int imageID, double x, double y, Direction dir, int maxDist, int damage); // Launch a projectile from (x,y)
+    int count() const {return static_cast<int>(m_x.size());} // Number of live projectiles
+    void clear(); // Remove all projectiles
+    // Segment projectile i covered since last tick (a single point on its first tick)
+    Coord fromX(int i) const {return m_fromX[i];}
+    Coord fromY(int i) const {return m_fromY[i];}
+    Coord toX(int i) const {return m_x[i];}
+    Coord toY(int i) const {return m_y[i];}
+    int damage(int i) const {return m_damage[i];}
+    void advance(int i); // Move projectile i forward one step (it is marked spent once out of distance)
+    void kill(int i) {m_maxDist[i] = 0;} // Mark projectile i spent
+    void removeSpent(); // Drop spent projectiles (keeping launch order) and redraw the rest
+
+private:
+    GraphObject::SpriteBatch m_flameSprites, m_spraySprites; // Sprites of the live projectiles
+    std::vector<Coord> m_x, m_y; // Current positions
+    std::vector<Coord> m_fromX, m_fromY; // Positions at the start of the current step
+    std::vector<Direction> m_dir; // Direction of travel
+    std::vector<int> m_maxDist; // Distance left to travel (0 once spent)
+    std::vector<int> m_damage; // Damage done on a hit
+    std::vector<int> m_imageID; // IID_FLAME or IID_SPRAY
+};
+
+//////////
+// ProjectileSystem inline implementation
+//////////
+
+inline void ProjectileSystem::add(int imageID, double x, double y, Direction dir, int maxDist, int damage)
+{
+    m_x.push_back(x);
+    m_y.push_back(y);
+    m_fromX.push_back(x);
+    m_fromY.push_back(y);
+    m_dir.push_back(dir);
+    m_maxDist.push_back(maxDist);
+    m_damage.push_back(damage);
+    m_imageID.push_back(imageID);
+    (imageID == IID_FLAME ? m_flameSprites : m_spraySprites).add(x, y, dir);
+}
+
+inline void ProjectileSystem::clear()
+{
+    m_x.clear();
+    m_y.clear();
+    m_fromX.clear();
+    m_fromY.clear();
+    m_dir.clear();
+    m_maxDist.clear();
+    m_damage.clear();
+    m_imageID.clear();
+    m_flameSprites.clear();
+    m_spraySprites.clear();
+}
+
+inline void ProjectileSystem::advance(int i)
+{
+    // Same step as Projectile::doSomething (2*SPRITE_RADIUS via getPositionInThisDirection)
+    m_fromX[i] = m_x[i];
+    m_fromY[i] = m_y[i];
+    advanceCoords(m_x[i], m_y[i], m_dir[i], 2*SPRITE_RADIUS);
+    m_maxDist[i] -= 2*SPRITE_RADIUS;
+    if (m_maxDist[i] < 0)
+        m_maxDist[i] = 0;
+}
+
+inline void ProjectileSystem::removeSpent()
+{
+    m_flameSprites.clear();
+    m_spraySprites.clear();
+    size_t kept = 0;
+    for (size_t i = 0; i < m_x.size(); i++)
+    {
+        if (m_maxDist[i] <= 0) // Spent
+            continue;
+        m_x[kept] = m_x[i];
+        m_y[kept] = m_y[i];
+        m_fromX[kept] = m_fromX[i];
+        m_fromY[kept] = m_fromY[i];
+        m_dir[kept] = m_dir[i];
+        m_maxDist[kept] = m_maxDist[i];
+        m_damage[kept] = m_damage[i];
+        m_imageID[kept] = m_imageID[i];
+        (m_imageID[i] == IID_FLAME ? m_flameSprites : m_spraySprites).add(m_x[i], m_y[i], m_dir[i]);
+        kept++;
+    }
+    m_x.resize(kept);
+    m_y.resize(kept);
+    m_fromX.resize(kept);
+    m_fromY.resize(kept);
+    m_dir.resize(kept);
+    m_maxDist.resize(kept);
+    m_damage.resize(kept);
+    m_imageID.resize(kept);
+}
+
+#endif // PROJECTILESYSTEM_H_
@@ -0,0 +1,102 @@
+#ifndef RENDERSNAPSHOT_H_
+#define RENDERSNAPSHOT_H_
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+  // Everything the GLUT thread needs to plot one GraphObject.  The animation
+  // number is reduced to a frame index at draw time, since only the
+  // SpriteManager knows how many frames each image has.
+
+struct SpriteRecord
+{
+    int     imageID;
+    unsigned int    animationNumber;
+    double  x;
+    double  y;
+    int     direction;
+    double  size;
+};
+
+  // With the static layer cached, sprites has only the dynamic sprites, and
+  // staticSprites has the static ones as of staticVersion (0 for none yet).
+  // staticSprites is refilled only when the static layer has changed since
+  // this buffer last held it.
+
+struct RenderSnapshot
+{
+    std::vector<SpriteRecord> sprites;
+    std::vector<SpriteRecord> staticSprites;
+    unsigned long             staticVersion = 0;
+    std::string               gameStatText;
+    unsigned long             tick = 0;
+};
+
+  // Hands finished snapshots from the simulation thread to the GLUT thread
+  // without either side ever waiting on the other.  Each side owns one
+  // buffer outright; the third slot sits in between and the two sides swap
+  // their buffer with it.  A published snapshot is never written again
+  // until the reader has moved on to a newer one.
+
+class RenderSnapshotBuffer
+{
+  public:
+
+    RenderSnapshotBuffer()
+     : m_writeIndex(0), m_pending(1), m_readIndex(2)
+    {
+    }
+
+      // The snapshot the simulation thread should fill in next
+    RenderSnapshot& backBuffer()
+    {
+        return m_buffers[m_writeIndex];
+    }
+
+      // Make the back buffer the latest snapshot and start a new back buffer
+    void publish()
+    {
+        m_writeIndex = m_pending.exchange(m_writeIndex | FRESH_BIT) & INDEX_MASK;
+    }
+
+      // The newest snapshot published so far (or the previous one again if
+      // nothing new has been published since the last call)
+    const RenderSnapshot& latest()
+    {
+        if (m_pending.load() & FRESH_BIT)
+            m_readIndex = m_pending.exchange(m_readIndex) & INDEX_MASK;
+        return m_buffers[m_readIndex];
+    }
+
+      // Only safe while no other thread is using the buffer
+    void clear()
+    {
+        for (RenderSnapshot& s : m_buffers)
+        {
+            s.sprites.clear();
+            s.staticSprites.clear();
+            s.staticVersion = 0;
+            s.gameStatText.clear();
+            s.tick = 0;
+        }
+        m_writeIndex = 0;
+        m_pending = 1;
+        m_readIndex = 2;
+    }
+
+      // Prevent copying or assigning RenderSnapshotBuffers
+    RenderSnapshotBuffer(const RenderSnapshotBuffer&) = delete;
+    RenderSnapshotBuffer& operator=(const RenderSnapshotBuffer&) = delete;
+
+  private:
+    static const int INDEX_MASK = 3;
+    static const int FRESH_BIT = 4;
+
+    RenderSnapshot   m_buffers[3];
+    int              m_writeIndex;
+    std::atomic<int> m_pending;
+    int              m_readIndex;
+};
+
+#endif // RENDERSNAPSHOT_H_
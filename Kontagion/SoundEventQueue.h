@@ -0,0 +1,100 @@
+#ifndef SOUNDEVENTQUEUE_H_
+#define SOUNDEVENTQUEUE_H_
+
+#include "GameConstants.h"
+#include <cstdint>
+
+  // Collects the sounds requested during one tick so the framework can play
+  // them after move() returns instead of from inside actor code.  Each sound
+  // ID is recorded at most once per tick, and an ID can be given a minimum
+  // number of ticks between plays so a population boom doesn't turn into a
+  // wall of identical clips.  When disabled (headless and batch runs), push()
+  // returns immediately and nothing is ever drained.
+
+class SoundEventQueue
+{
+  public:
+
+    SoundEventQueue()
+     : m_enabled(true), m_pending(0), m_stop(false), m_tick(0)
+    {
+        for (int id = 0; id < MAX_SOUND_IDS; id++)
+        {
+            m_minTicksBetween[id] = 0;
+            m_lastTick[id] = NEVER;
+        }
+    }
+
+    void setEnabled(bool enabled)
+    {
+        m_enabled = enabled;
+        if (!enabled)
+        {
+            m_pending = 0;
+            m_stop = false;
+        }
+    }
+
+    bool isEnabled() const
+    {
+        return m_enabled;
+    }
+
+      // Play soundID at most once every minTicks ticks
+    void setRateLimit(int soundID, int minTicks)
+    {
+        if (soundID >= 0  &&  soundID < MAX_SOUND_IDS)
+            m_minTicksBetween[soundID] = minTicks;
+    }
+
+      // SOUND_NONE cancels everything queued so far this tick and stops
+      // whatever is playing
+    void push(int soundID)
+    {
+        if (!m_enabled)
+            return;
+        if (soundID == SOUND_NONE)
+        {
+            m_pending = 0;
+            m_stop = true;
+        }
+        else if (soundID >= 0  &&  soundID < MAX_SOUND_IDS)
+            m_pending |= uint64_t(1) << soundID;
+    }
+
+      // Hand this tick's sounds to playFunc (in sound ID order, after a
+      // SOUND_NONE if one was pushed) and start a new tick
+    template<typename Func>
+    void drain(Func playFunc)
+    {
+        m_tick++;
+        if (m_stop)
+        {
+            m_stop = false;
+            playFunc(SOUND_NONE);
+        }
+        for (int id = 0; m_pending != 0; id++)
+        {
+            uint64_t bit = uint64_t(1) << id;
+            if ((m_pending & bit) == 0)
+                continue;
+            m_pending &= ~bit;
+            if (m_lastTick[id] != NEVER  &&  m_tick - m_lastTick[id] < m_minTicksBetween[id])
+                continue;
+            m_lastTick[id] = m_tick;
+            playFunc(id);
+        }
+    }
+
+  private:
+    static const long NEVER = -1;
+
+    bool     m_enabled;
+    uint64_t m_pending;
+    bool     m_stop;
+    long     m_tick;
+    int      m_minTicksBetween[MAX_SOUND_IDS];
+    long     m_lastTick[MAX_SOUND_IDS];
+};
+
+#endif // SOUNDEVENTQUEUE_H_
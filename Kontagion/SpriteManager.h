@@ -12,10 +12,11 @@
 #endif
 
 #include "GameConstants.h"
+#include "MappedFile.h"
 #include <iostream>
-#include <fstream>
+#include <cstring>
 #include <string>
-#include <map>
+#include <vector>
 #include <memory>
 #include <cmath>
 
@@ -31,49 +32,84 @@ class SpriteManager
 public:
 
     SpriteManager()
-     : m_mipMapped(true)
+     : m_frameCountPerImage(), m_mipMapped(true)
     {
     }
 
-    bool loadSprite(std::string filename_tga, int imageID, int frameNum)
+      // Pixels of one TGA file, ready to hand to OpenGL.  Uncompressed
+      // pixels point straight into the mapped file; RLE-compressed ones
+      // into a buffer they were expanded into.
+    struct SpriteImage
     {
-          // Load Texture Data From TGA File
-
-        int spriteID = getSpriteID(imageID, frameNum);
-        if (spriteID == INVALID_SPRITE_ID)
+        unsigned int                width = 0;
+        unsigned int                height = 0;
+        unsigned char               byteCount = 0;      // 3 (BGR) or 4 (BGRA)
+        const char*                 pixels = nullptr;
+        std::unique_ptr<MappedFile> file;
+        std::unique_ptr<char[]>     decoded;
+    };
+
+      // Map, validate, and (if RLE-compressed) decode a TGA file.  Touches
+      // no OpenGL or SpriteManager state, so it may run on any thread.
+    static bool readSprite(std::string filename_tga, SpriteImage& image)
+    {
+        std::unique_ptr<MappedFile> file(new MappedFile);
+        if (!file->open(filename_tga)  ||  file->size() < TGA_HEADER_SIZE)
             return false;
+        const unsigned char* header = file->data();
 
-        m_frameCountPerSprite[imageID]++;   // keep track of how many frames per sprite we loaded
+          // image type either 2 (color) or 3 (greyscale), or 10 or 11 for
+          // their run-length encoded versions; no color map
+        int type = header[2];
+        if (header[1] != 0 || (type != 2 && type != 3 && type != 10 && type != 11))
+            return false;
 
-        std::ifstream tgaFile(filename_tga, std::ios::in|std::ios::binary);
-        if (!tgaFile)
+        image.width = header[12] + header[13] * 256;
+        image.height = header[14] + header[15] * 256;
+        image.byteCount = header[16] / 8;
+        if (image.byteCount != 3 && image.byteCount != 4)
+            return false;
+        if (image.width == 0 || image.height == 0)
             return false;
 
-        char type[3];
-        char info[6];
-
-          // Read file header info
-        tgaFile.read(type, 3);
-        tgaFile.seekg(12);
-        tgaFile.read(info, 6);
-        unsigned int textureWidth = static_cast<unsigned char>(info[0]) + static_cast<unsigned char>(info[1]) * 256;
-        unsigned int textureHeight = static_cast<unsigned char>(info[2]) + static_cast<unsigned char>(info[3]) * 256;
-        unsigned char byteCount = static_cast<unsigned char>(info[4]) / 8;
-        long imageSize = textureWidth * textureHeight * byteCount;
-        std::unique_ptr<char[]> imageData(new char[imageSize]);
-        tgaFile.seekg(18);
-          // Read image data
-        tgaFile.read(imageData.get(), imageSize);
-        if (!tgaFile)
+          // Image data follows the header and the optional image ID
+        size_t offset = TGA_HEADER_SIZE + header[0];
+        size_t imageSize = size_t(image.width) * image.height * image.byteCount;
+        if (offset > file->size())
             return false;
 
-          //image type either 2 (color) or 3 (greyscale)
-        if (type[1] != 0 || (type[2] != 2 && type[2] != 3))
+        if (type == 2 || type == 3)
+        {
+            if (file->size() - offset < imageSize)
+                return false;
+            image.pixels = reinterpret_cast<const char*>(file->data() + offset);
+            image.file = std::move(file);
+            return true;
+        }
+
+        image.decoded.reset(new char[imageSize]);
+        if (!decodeRLE(file->data() + offset, file->size() - offset, image.byteCount, image.decoded.get(), imageSize))
             return false;
+        image.pixels = image.decoded.get();
+        return true;
+    }
 
-        if (byteCount != 3 && byteCount != 4)
+    bool loadSprite(std::string filename_tga, int imageID, int frameNum)
+    {
+        SpriteImage image;
+        return readSprite(filename_tga, image)  &&  uploadSprite(image, imageID, frameNum);
+    }
+
+      // Transfer a decoded image to OpenGL as a frame of imageID.  Must be
+      // called on the thread that owns the GL context.
+    bool uploadSprite(const SpriteImage& image, int imageID, int frameNum)
+    {
+        int spriteID = getSpriteID(imageID, frameNum);
+        if (spriteID == INVALID_SPRITE_ID)
             return false;
 
+        m_frameCountPerImage[imageID]++;    // keep track of how many frames per sprite we loaded
+
           // Transfer Texture To OpenGL
 
         glEnable(GL_DEPTH_TEST);
@@ -104,33 +140,45 @@ public:
         glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, static_cast<GLfloat>(GL_REPEAT));
         glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, static_cast<GLfloat>(GL_REPEAT));
 
+        unsigned char byteCount = image.byteCount;
+        unsigned int textureWidth = image.width;
+        unsigned int textureHeight = image.height;
+        const char* imageData = image.pixels;
         if (m_mipMapped)
         {
               // build our texture mipmaps
               // byteCount of 3 means that BGR data is being supplied. byteCount of 4 means that BGRA data is being supplied.
-            makeMipmaps(byteCount, textureWidth, textureHeight, imageData.get());
+            makeMipmaps(byteCount, textureWidth, textureHeight, imageData);
         }
         else
         {
               // byteCount of 3 means that BGR data is being supplied. byteCount of 4 means that BGRA data is being supplied.
             if (3 == byteCount)
-                glTexImage2D(GL_TEXTURE_2D, 0, 3, textureWidth, textureHeight, 0, GL_BGR, GL_UNSIGNED_BYTE, imageData.get());
+                glTexImage2D(GL_TEXTURE_2D, 0, 3, textureWidth, textureHeight, 0, GL_BGR, GL_UNSIGNED_BYTE, imageData);
             else if (4 == byteCount)
-                glTexImage2D(GL_TEXTURE_2D, 0, 4, textureWidth, textureHeight, 0, GL_BGRA, GL_UNSIGNED_BYTE, imageData.get());
+                glTexImage2D(GL_TEXTURE_2D, 0, 4, textureWidth, textureHeight, 0, GL_BGRA, GL_UNSIGNED_BYTE, imageData);
         }
 
-        m_imageMap[spriteID] = glTextureID;
+        if (m_textures.size() <= static_cast<size_t>(spriteID))
+            m_textures.resize((imageID + 1) * MAX_FRAMES_PER_SPRITE, NO_TEXTURE);
+        m_textures[spriteID] = glTextureID;
 
         return true;
     }
 
     int getNumFrames(int imageID) const
     {
-        auto it = m_frameCountPerSprite.find(imageID);
-        if (it == m_frameCountPerSprite.end())
+        if (imageID < 0 || imageID >= MAX_IMAGES)
             return 0;
 
-        return it->second;
+        return m_frameCountPerImage[imageID];
+    }
+
+      // Which of imageID's frames to show for a given animation number
+    int getFrame(int imageID, unsigned int animationNumber) const
+    {
+        int numFrames = getNumFrames(imageID);
+        return numFrames <= 1 ? 0 : static_cast<int>(animationNumber % numFrames);
     }
 
     bool plotSprite(int imageID, int frame, double x, double y, int angleDegrees, double size)
@@ -139,14 +187,16 @@ public:
         if (spriteID == INVALID_SPRITE_ID)
             return false;
 
-        auto it = m_imageMap.find(spriteID);
-        if (it == m_imageMap.end())
+        GLuint texture = getTexture(spriteID);
+        if (texture == NO_TEXTURE)
             return false;
 
         glPushMatrix();
 
-        double finalWidth = SPRITE_WIDTH_GL * size;
-        double finalHeight = SPRITE_HEIGHT_GL * size;
+          // Sprites keep their world size, so they shrink on screen in a large dish
+        double viewScale = double(VIEW_WIDTH) / dish().width;
+        double finalWidth = SPRITE_WIDTH_GL * size * viewScale;
+        double finalHeight = SPRITE_HEIGHT_GL * size * viewScale;
 
         // object's x/y location is center-based, but sprite plotting is upper-left-corner based
         const double xoffset = 0;// finalWidth / 2;
@@ -160,7 +210,7 @@ public:
         glDisable(GL_DEPTH_TEST);
         glEnable (GL_BLEND);
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glBindTexture(GL_TEXTURE_2D, it->second);
+        glBindTexture(GL_TEXTURE_2D, texture);
 
         glColor3f(1.0, 1.0, 1.0);
 
@@ -219,19 +269,31 @@ public:
 
     ~SpriteManager()
     {
-        for (auto it = m_imageMap.begin(); it != m_imageMap.end(); it++)
-            glDeleteTextures(1, &it->second);
+        for (GLuint texture : m_textures)
+        {
+            if (texture != NO_TEXTURE)
+                glDeleteTextures(1, &texture);
+        }
     }
 
 private:
 
-    std::map<int, GLuint>   m_imageMap;
-    std::map<int, int>      m_frameCountPerSprite;
-    bool                    m_mipMapped;
-
     static const int INVALID_SPRITE_ID = -1;
     static const int MAX_IMAGES = 1000;
     static const int MAX_FRAMES_PER_SPRITE = 100;
+    static constexpr GLuint NO_TEXTURE = 0;     // glGenTextures never returns 0
+    static const size_t TGA_HEADER_SIZE = 18;
+
+      // Texture for each sprite ID (imageID * MAX_FRAMES_PER_SPRITE + frame);
+      // image IDs are small, so this stays a few thousand entries
+    std::vector<GLuint>     m_textures;
+    int                     m_frameCountPerImage[MAX_IMAGES];
+    bool                    m_mipMapped;
+
+    GLuint getTexture(int spriteID) const
+    {
+        return static_cast<size_t>(spriteID) < m_textures.size() ? m_textures[spriteID] : NO_TEXTURE;
+    }
 
     static int getSpriteID(int imageID, int frame)
     {
@@ -251,14 +313,51 @@ private:
 
     static void convertToGlutCoords(double x, double y, double& gx, double& gy, double& gz)
     {
-        x /= VIEW_WIDTH;
-        y /= VIEW_HEIGHT;
+        x /= dish().width;
+        y /= dish().height;
         gx = 2 * VISIBLE_MIN_X + .3 + x * 2 * (VISIBLE_MAX_X - VISIBLE_MIN_X);
         gy = 2 * VISIBLE_MIN_Y +      y * 2 * (VISIBLE_MAX_Y - VISIBLE_MIN_Y);
         gz = .6 * VISIBLE_MIN_Z;
     }
 
-    static void makeMipmaps(unsigned char byteCount, unsigned int textureWidth, unsigned int textureHeight, char* imageData)
+      // Expand run-length encoded TGA pixel data (packets of one repeated
+      // pixel or of up to 128 literal ones) into exactly outSize bytes.
+      // Returns false if the data runs out or a packet overflows the image.
+    static bool decodeRLE(const unsigned char* in, size_t inSize, unsigned char byteCount, char* out, size_t outSize)
+    {
+        size_t inPos = 0;
+        size_t outPos = 0;
+        while (outPos < outSize)
+        {
+            if (inPos >= inSize)
+                return false;
+            unsigned char packet = in[inPos++];
+            size_t nBytes = size_t((packet & 0x7f) + 1) * byteCount;
+            if (nBytes > outSize - outPos)
+                return false;
+            if (packet & 0x80)
+            {
+                  // Run: one pixel, repeated
+                if (inSize - inPos < byteCount)
+                    return false;
+                for (size_t k = 0; k < nBytes; k += byteCount)
+                    std::memcpy(out + outPos + k, in + inPos, byteCount);
+                inPos += byteCount;
+            }
+            else
+            {
+                  // Raw: literal pixels
+                if (inSize - inPos < nBytes)
+                    return false;
+                std::memcpy(out + outPos, in + inPos, nBytes);
+                inPos += nBytes;
+            }
+            outPos += nBytes;
+        }
+        return true;
+    }
+
+    static void makeMipmaps(unsigned char byteCount, unsigned int textureWidth, unsigned int textureHeight, const char* imageData)
     {
         int format = (byteCount == 3 ? GL_BGR : GL_BGRA);
 #ifdef __APPLE__
@@ -0,0 +1,80 @@
+#ifndef STATUSLINE_H_
+#define STATUSLINE_H_
+
+#include <charconv>
+
+// Formats the game status line into a fixed buffer that lives as long as the
+// StatusLine does, so the text can be handed out by pointer rather than
+// copied.  The line is only rebuilt when one of its values changes.
+
+class StatusLine
+{
+public:
+    StatusLine() : m_valid(false) {m_text[0] = '\0';}
+    // Reformat if any value differs from the last call; returns whether the text changed
+    bool update(int score, int level, int lives, int health, int sprays, int flames);
+    const char* c_str() const {return m_text;} // Always nul-terminated
+
+private:
+    static const int NUM_FIELDS = 6;
+    static const int MAX_LENGTH = 128; // 6 labels plus 6 ints fit with room to spare
+    int m_values[NUM_FIELDS]; // Values the current text was built from
+    bool m_valid; // Whether m_values holds anything yet
+    char m_text[MAX_LENGTH];
+
+    static char* append(char* out, const char* s); // Copy a label, returning the new end
+    static char* append(char* out, int value, int width = 0); // Write an int zero-padded to width, returning the new end
+};
+
+inline bool StatusLine::update(int score, int level, int lives, int health, int sprays, int flames)
+{
+    const int values[NUM_FIELDS] = {score, level, lives, health, sprays, flames};
+    bool changed = !m_valid;
+    for (int i = 0; i < NUM_FIELDS && !changed; i++)
+        changed = (values[i] != m_values[i]);
+    if (!changed)
+        return false;
+
+    for (int i = 0; i < NUM_FIELDS; i++)
+        m_values[i] = values[i];
+    m_valid = true;
+
+    // Same layout as the original ostringstream version: "Score: 000120  Level: 1  ..."
+    char* out = m_text;
+    out = append(out, "Score: ");
+    out = append(out, score, 6);
+    out = append(out, "  Level: ");
+    out = append(out, level);
+    out = append(out, "  Lives: ");
+    out = append(out, lives);
+    out = append(out, "  Health: ");
+    out = append(out, health);
+    out = append(out, "  Sprays: ");
+    out = append(out, sprays);
+    out = append(out, "  Flames: ");
+    out = append(out, flames);
+    out = append(out, "  ");
+    *out = '\0';
+    return true;
+}
+
+inline char* StatusLine::append(char* out, const char* s)
+{
+    while (*s != '\0')
+        *out++ = *s++;
+    return out;
+}
+
+inline char* StatusLine::append(char* out, int value, int width)
+{
+    char digits[16];
+    char* end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+    // Pad on the left like setw with fill '0' (which pads before any minus sign too)
+    for (int pad = width - static_cast<int>(end - digits); pad > 0; pad--)
+        *out++ = '0';
+    for (char* p = digits; p != end; p++)
+        *out++ = *p;
+    return out;
+}
+
+#endif // STATUSLINE_H_
@@ -0,0 +1,111 @@
+#ifndef STROKETEXTCACHE_H_
+#define STROKETEXTCACHE_H_
+
+#include "freeglut.h"
+#include <string>
+#include <unordered_map>
+
+  // Compiles each distinct string's glutStrokeCharacter calls into a display
+  // list the first time it is drawn, along with its glutStrokeLength, so
+  // redrawing the same HUD text or prompt every frame is one glCallList.
+  // Strings that haven't been drawn recently are evicted once the cache is
+  // full, since the status line changes over the course of a game.
+
+class StrokeTextCache
+{
+  public:
+
+    StrokeTextCache()
+     : m_frame(0)
+    {
+    }
+
+    ~StrokeTextCache()
+    {
+        clear();
+    }
+
+      // Draw str with the current transform, as glutStrokeCharacter would
+    void draw(const char* str)
+    {
+        glCallList(lookup(str).displayList);
+    }
+
+      // Same as glutStrokeLength(GLUT_STROKE_ROMAN, str)
+    double length(const char* str)
+    {
+        return lookup(str).length;
+    }
+
+      // Call once per frame so eviction can tell what is still in use
+    void nextFrame()
+    {
+        m_frame++;
+    }
+
+    void clear()
+    {
+        for (auto& e : m_entries)
+            glDeleteLists(e.second.displayList, 1);
+        m_entries.clear();
+    }
+
+      // Prevent copying or assigning StrokeTextCaches
+    StrokeTextCache(const StrokeTextCache&) = delete;
+    StrokeTextCache& operator=(const StrokeTextCache&) = delete;
+
+  private:
+
+    struct Entry
+    {
+        GLuint        displayList;
+        double        length;
+        unsigned long lastUsedFrame;
+    };
+
+    static const size_t MAX_ENTRIES = 32;
+
+    std::unordered_map<std::string, Entry> m_entries;
+    std::string   m_key;    // reused so lookups don't allocate
+    unsigned long m_frame;
+
+    Entry& lookup(const char* str)
+    {
+        m_key.assign(str);
+        auto it = m_entries.find(m_key);
+        if (it == m_entries.end())
+        {
+            if (m_entries.size() >= MAX_ENTRIES)
+                evictLeastRecentlyUsed();
+            it = m_entries.emplace(m_key, compile(str)).first;
+        }
+        it->second.lastUsedFrame = m_frame;
+        return it->second;
+    }
+
+    static Entry compile(const char* str)
+    {
+        Entry e;
+        e.displayList = glGenLists(1);
+        e.length = glutStrokeLength(GLUT_STROKE_ROMAN, reinterpret_cast<const unsigned char*>(str));
+        glNewList(e.displayList, GL_COMPILE);
+        for ( ; *str != '\0'; str++)
+            glutStrokeCharacter(GLUT_STROKE_ROMAN, *str);
+        glEndList();
+        return e;
+    }
+
+    void evictLeastRecentlyUsed()
+    {
+        auto oldest = m_entries.begin();
+        for (auto it = m_entries.begin(); it != m_entries.end(); it++)
+        {
+            if (it->second.lastUsedFrame < oldest->second.lastUsedFrame)
+                oldest = it;
+        }
+        glDeleteLists(oldest->second.displayList, 1);
+        m_entries.erase(oldest);
+    }
+};
+
+#endif // STROKETEXTCACHE_H_
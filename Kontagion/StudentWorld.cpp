@@ -4,9 +4,12 @@
 using namespace std;
 
 #include <cmath>
-#include <sstream>
-#include <iomanip>
+#include <algorithm>
 #include "Actor.h"
+#include "Profiler.h"
+#include "GoldenTrace.h"
+#include <chrono>
+#include <iostream>
 
 GameWorld* createStudentWorld(string assetPath)
 {
@@ -25,7 +28,29 @@ StudentWorld::StudentWorld(string assetPath)
 {
     // Construction sets player pointer to null and number of actors to 0
     m_player = nullptr;
-    m_nActors = 0;
+    m_controller = nullptr;
+    m_peakActors = 0;
+    m_nextSeq = 0;
+    m_nLevelBlockers = 0;
+    m_areaX = m_areaY = 0;
+    m_tick = 0;
+    m_builtLevel = 0;
+    m_ticksToFungus = m_ticksToGoodie = 0;
+    fill(begin(m_sectorCounts), end(m_sectorCounts), 0);
+    // Register every concrete actor type with the memory ledger
+    m_ledger.addType<Socrates>("Socrates");
+    m_ledger.addType<RegSalmonella>("RegSalmonella");
+    m_ledger.addType<AggSalmonella>("AggSalmonella");
+    m_ledger.addType<EColi>("EColi");
+    m_ledger.addType<Pit>("Pit");
+    m_ledger.addType<Food>("Food");
+    m_ledger.addType<Fungus>("Fungus");
+    m_ledger.addType<RestoreHealthGoodie>("RestoreHealthGoodie");
+    m_ledger.addType<FlameThrowerGoodie>("FlameThrowerGoodie");
+    m_ledger.addType<ExtraLifeGoodie>("ExtraLifeGoodie");
+    m_ledger.addType<Spray>("Spray");
+    m_ledger.addType<Flame>("Flame");
+    m_ledger.addType<FlameBurst>("FlameBurst");
 }
 
 // StudentWorld Destructor
@@ -38,28 +63,43 @@ StudentWorld::~StudentWorld()
 // StudentWorld Initializer
 int StudentWorld::init()
 {
+    m_grid.reset(dish().width, dish().height); // Size the spatial index to the dish
+    m_dirt.reset(dish().width, dish().height); // Same for the dirt layer
+    m_batch.reset(dish().width, dish().height); // And the batched pass's food index
     // Construct Socrates
     m_player = new Socrates(this);
+    m_metrics.allocations++;
+    m_ledger.add(m_player);
+    if (gameOptions().autoPlay) // Let the auto player play Socrates
+        m_controller = new AutoPlayer(this, m_player);
     // Construct Pits
     int level = getLevel(); // Gets current level
+    m_builtLevel = level; // Remember it for cleanUp's memory report
+    double scale = dish().populationScale(); // 1 for the classic dish, larger for large dishes
+    reserveActors(plannedActorCount(level, scale)); // Room for the whole level up front, so it rarely reallocates
     int x, y;
-    for (int i = 0; i < level; i++) // Loops (level) times
+    for (int i = 0; i < level * scale; i++) // Loops (level) times (scaled to dish size)
     {
-        genUniqueCoords(x, y, m_nActors); // Generate unique coords with respect to all actors so far (pits only)
+        genUniqueCoords(x, y, static_cast<int>(m_actors.size())); // Generate unique coords with respect to all actors so far (pits only)
         addActor(new Pit(x, y, this)); // Add Pit to world with coords
     }
     // Construct Food
-    for (int i = 0; i < min(5*level, 25); i++) // Loops specified times as shown in spec for Food
+    for (int i = 0; i < min(5*level, 25) * scale; i++) // Loops specified times as shown in spec for Food (scaled to dish size)
     {
-        genUniqueCoords(x, y, m_nActors); // Generate unique coords with respect to all actors so far (pits and food only)
+        genUniqueCoords(x, y, static_cast<int>(m_actors.size())); // Generate unique coords with respect to all actors so far (pits and food only)
         addActor(new Food(x, y, this)); // Add Food to world with coords
     }
     // Construct Dirt
-    int nPitsAndFood = m_nActors; // Record how many pits and food there are currently in the world since only pits and food have been constructed
-    for (int i = 0; i < max(180-20*level, 20); i++) // Loop specified times as in spec for Dirt
+    int nPitsAndFood = static_cast<int>(m_actors.size()); // Record how many pits and food there are currently in the world since only pits and food have been constructed
+    for (int i = 0; i < max(180-20*level, 20) * scale; i++) // Loop specified times as in spec for Dirt (scaled to dish size)
     {
         genUniqueCoords(x, y, nPitsAndFood); // Generate unique coords with respect to only the Pits and Food (Dirt can overlap each other)
-        addActor(new Dirt(x, y, this)); // Add Dirt to world with coords
+        m_dirt.add(x, y); // Add Dirt to the dirt layer with coords
+    }
+    if (gameOptions().sampledEvents) // Draw when the first fungus and goodie appear (their odds depend on the level)
+    {
+        m_ticksToFungus = randTicksUntil(max(510 - level * 10, 200));
+        m_ticksToGoodie = randTicksUntil(max(510 - level * 10, 250));
     }
     
     return GWSTATUS_CONTINUE_GAME; // Continue game
@@ -68,6 +108,29 @@ int StudentWorld::init()
 // StudentWorld move function for every tick
 int StudentWorld::move()
 {
+    PROFILE_TICK(); // Close out the previous tick's counters
+    PROFILE_SCOPE("StudentWorld::move");
+    MetricsExporter* metrics = getMetrics();
+    if (metrics == nullptr) // Nobody watching, so don't time the tick
+        return playTick();
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    int status = playTick();
+    m_metrics.addTickLatency(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+    publishMetrics(*metrics);
+    return status;
+}
+
+// StudentWorld method to play one tick (the body of move)
+int StudentWorld::playTick()
+{
+    m_tick++; // Start the next tick
+    m_batch.finish(); // Nothing measured yet this tick
+    m_woken.clear();
+    m_timers.advance([this](Actor* a) // Dormant actors whose wake-up tick this is
+    {
+        a->setTimer(-1);
+        m_woken.push_back(a);
+    });
     // Make Socrates do its action
     m_player->doSomething();
     if (m_player->isDead()) // Check if player is killed
@@ -75,17 +138,37 @@ int StudentWorld::move()
         decLives(); // Decrease world lives
         return GWSTATUS_PLAYER_DIED; // Return to game that player died
     }
+    moveProjectiles(); // Swept projectiles (including any just fired) act right after Socrates
     if (isLevelOver()) // Check if Level is completed
     {
         playSound(SOUND_FINISHED_LEVEL); // Play level completion soun
         return GWSTATUS_FINISHED_LEVEL; // Return to game the level is completed
     }
     
-    for (int i = 0; i < m_nActors; i++) // Loops through all actors in world
+    wakeTouchingPlayer(); // Socrates stays put, so only dormant actors touching him now can be picked up this tick
+    sort(m_woken.begin(), m_woken.end(), [](Actor* a, Actor* b) {return a->getSeq() < b->getSeq();});
+    m_woken.erase(unique(m_woken.begin(), m_woken.end()), m_woken.end()); // Woken by both
+    if (gameOptions().batchedBacteria) // Socrates stays put for the rest of the tick, so measure what the bacteria will ask all at once
+        m_batch.measure(m_active, m_actors, m_player);
+    // Loop through the active actors and the woken dormant ones together, in the order they were added to the world
+    // (the same order as all of m_actors, so everything acts exactly when it would if every actor acted every tick)
+    size_t w = 0; // Next woken actor
+    for (int i = 0; i < static_cast<int>(m_active.size()) || w < m_woken.size(); )
     {
-        if (!m_actors[i]->isDead()) // Check if current actor is alive
+        Actor* a;
+        if (w < m_woken.size() && (i >= static_cast<int>(m_active.size()) || m_woken[w]->getSeq() < m_active[i]->getSeq()))
+        {
+            m_batch.setActing(-1); // Dormant actors aren't measured
+            a = m_woken[w++];
+        }
+        else
         {
-            m_actors[i]->doSomething(); // Make actor do something
+            m_batch.setActing(i); // Lets queries use this actor's measurements (if it has any)
+            a = m_active[i++];
+        }
+        if (!a->isDead()) // Check if current actor is alive
+        {
+            a->doSomething(); // Make actor do something
             
             if (m_player->isDead()) // Check if player is killed
             {
@@ -99,12 +182,14 @@ int StudentWorld::move()
             }
         }
     }
+    m_batch.finish(); // Done with this tick's measurements
     // Delete dead Actors
     deleteDead();
     // Add Actors
     addItems();
-    // Update Status Line
-    updateStatusText();
+    // Update Status Line (nobody sees it while fast-forwarding; the next normal tick catches it up)
+    if (!isFastForwarding())
+        updateStatusText();
     
     return GWSTATUS_CONTINUE_GAME; // Continue game
 }
@@ -112,51 +197,340 @@ int StudentWorld::move()
 // StudentWorld cleanUp method to deallocate all actors in world
 void StudentWorld::cleanUp()
 {
+    if (m_player != nullptr && gameOptions().memoryReport) // Report the level's memory use before tearing it down
+    {
+        cout << "Level " << m_builtLevel << " actor memory (" << GraphObject::registeredCount() << " GraphObjects registered):" << endl;
+        m_ledger.report(cout);
+    }
+    if (m_player != nullptr)
+        m_ledger.remove(m_player);
+    for (Actor* a : m_actors)
+        m_ledger.remove(a);
+    m_ledger.resetPeaks(); // Next level's peaks start from nothing
     delete m_player; // Delete Socrates
     m_player = nullptr; // Set player pointer to null to prevent double deletion
-    auto it = m_actors.begin(); // Create iterator pointing to start of actor vector
-    while (it != m_actors.end()) // Loop through all actors in vector
+    delete m_controller; // Delete auto player (if any)
+    m_controller = nullptr;
+    for (Actor* a : m_actors) // Loop through all actors in vector
+        delete a; // Deallocate actor
+    m_actors.clear(); // Erase all actor pointers at once
+    m_active.clear();
+    m_woken.clear();
+    m_timers.reset(m_tick); // Drop all wake-ups
+    m_nLevelBlockers = 0; // No actors left to block level completion
+    fill(begin(m_metrics.actors), end(m_metrics.actors), 0); // No actors of any type left
+    m_grid.reset(dish().width, dish().height); // Drop grid's pointers to deleted actors
+    m_dirt.reset(dish().width, dish().height); // Remove all dirt
+    m_batch.reset(dish().width, dish().height); // Drop the batched pass's pointers to deleted actors
+    fill(begin(m_sectorCounts), end(m_sectorCounts), 0); // No bacteria left in any sector
+    m_projectiles.clear(); // Remove all swept projectiles
+}
+
+// StudentWorld method to add what isn't drawn to a golden trace hash (positions and directions are drawn)
+void StudentWorld::hashState(StateHash& hash)
+{
+    if (m_player != nullptr) // Socrates' hp and charges
     {
-        delete (*it); // Deallocate actor
-        it = m_actors.erase(it); // Erase actor pointer from vector
+        hash.add(m_player->getHP());
+        hash.add(m_player->getSprays());
+        hash.add(m_player->getFlames());
+        hash.endItem();
     }
-    if (m_actors.size() != 0) // Check if all actors in vector have been deleted
+    for (Actor* a : m_actors) // Hp of every actor that has it, tagged with its position
     {
-        // Error message and exit if cleanup fails (vector isn't empty)
-        // Should never reach here
-        cerr << "BAD CLEANUP" << endl;
-        exit(1);
+        HP* hp = dynamic_cast<HP*>(a);
+        if (hp == nullptr)
+            continue;
+        hash.add(a->getX());
+        hash.add(a->getY());
+        hash.add(hp->getHP());
+        hash.endItem();
     }
-    m_nActors = 0; // Reset number of actors tracker to 0
+}
+
+// StudentWorld method to publish this tick's metrics (counts kept as actors come and go, the rest read now)
+void StudentWorld::publishMetrics(MetricsExporter& metrics)
+{
+    m_metrics.tick = m_tick;
+    m_metrics.level = getLevel();
+    m_metrics.score = getScore();
+    m_metrics.lives = getLives();
+    m_metrics.actors[IID_PLAYER] = (m_player != nullptr ? 1 : 0);
+    m_metrics.actors[IID_DIRT] = m_dirt.count();
+    m_metrics.projectiles = m_projectiles.count();
+    m_metrics.actorVectorSize = m_actors.size();
+    m_metrics.actorVectorCapacity = m_actors.capacity();
+    m_metrics.actorBytes = m_ledger.bytes();
+    m_metrics.peakActorBytes = m_ledger.peakBytes();
+    metrics.publish(m_metrics);
 }
 
 // StudentWorld method to add an actor to the world
 void StudentWorld::addActor(Actor* a)
 {
+    a->setSeq(m_nextSeq++); // Record insertion order (matches order in actor vector)
+    m_metrics.allocations++; // The actor itself
+    if (m_actors.size() == m_actors.capacity()) // Population spike beyond the plan, so double the room (bacteria divide, so spikes compound)
+        reserveActors(max(2 * m_actors.capacity(), MIN_ACTOR_CAPACITY));
     m_actors.push_back(a); // Pushes passed in actor pointer to the actor vector
-    m_nActors++; // Increments actor number tracker
+    if (!a->isDormant()) // Dormant actors only act when woken (m_active has the same capacity and is never longer, so it has room)
+        m_active.push_back(a);
+    m_peakActors = max(m_peakActors, m_actors.size()); // Remember the biggest population for planning later levels
+    m_metrics.actors[a->getImageID()]++; // Count actor by type
+    m_ledger.add(a); // Charge its memory to its type
+    m_grid.insert(a); // Index actor by position
+    if (a->preventsLevelCompletion()) // Count actors that keep the level going
+        m_nLevelBlockers++;
+    if (a->isEdible()) // New food could change any measured food answer
+        m_batch.foodAdded();
+    if (gameOptions().autoPlay && a->isBacteria()) // Count it in its rim sector for the auto player
+        countInSector(a, rimSector(a->getX(), a->getY()));
+    PROFILE_COUNT(ACTORS_SPAWNED, 1);
+}
+
+// StudentWorld method to estimate how many actors a level will hold at once
+size_t StudentWorld::plannedActorCount(int level, double scale) const
+{
+    size_t nPits = static_cast<size_t>(ceil(level * scale)); // Same counts init's loops construct
+    size_t nFood = static_cast<size_t>(ceil(min(5*level, 25) * scale));
+    size_t planned = nPits + nFood + nPits * Pit::N_BACTERIA + SPIKE_HEADROOM; // Pits, food, everything the pits will emit, and headroom
+    return max(planned, m_peakActors); // Levels that got more crowded than planned raise the plan for the rest
+}
+
+// StudentWorld method to make room for n actors
+void StudentWorld::reserveActors(size_t n)
+{
+    if (n <= m_actors.capacity()) // Already have room
+        return;
+    m_actors.reserve(n);
+    m_active.reserve(m_actors.capacity()); // Kept as big as m_actors, so pushing onto it never reallocates either
+    m_metrics.allocations += 2;
+    m_metrics.actorVectorGrowths++;
+}
+
+// StudentWorld method to launch a swept projectile
+void StudentWorld::addProjectile(int imageID, int x, int y, Direction dir, int maxDist, int dmg)
+{
+    m_projectiles.add(imageID, x, y, dir, maxDist, dmg);
+    PROFILE_COUNT(ACTORS_SPAWNED, 1);
+}
+
+// StudentWorld method to step all swept projectiles
+// Each one damages the first thing it overlapped anywhere along its last step and disappears, otherwise it moves on
+void StudentWorld::moveProjectiles()
+{
+    if (m_projectiles.count() == 0)
+        return;
+    PROFILE_SCOPE("StudentWorld::moveProjectiles");
+    for (int i = 0; i < m_projectiles.count(); i++)
+    {
+        if (damageAlongPath(m_projectiles.fromX(i), m_projectiles.fromY(i), m_projectiles.toX(i), m_projectiles.toY(i), m_projectiles.damage(i)))
+        {
+            m_projectiles.kill(i); // Projectile is used up by the hit
+            PROFILE_COUNT(ACTORS_DESTROYED, 1);
+        }
+        else
+            m_projectiles.advance(i); // Move forward 2*SPRITE_RADIUS
+    }
+    m_projectiles.removeSpent();
+}
+
+// StudentWorld method to damage the first damageable actor or dirt overlapping the segment from (ax,ay) to (bx,by)
+// "First" is nearest to a along the segment; ties go to dirt, then to the earliest-added actor
+bool StudentWorld::damageAlongPath(double ax, double ay, double bx, double by, int dmg)
+{
+    PROFILE_COUNT(QUERIES, 1);
+    double dx = bx - ax, dy = by - ay; // Segment vector
+    double lenSq = dx*dx + dy*dy;
+    // Parameter (0 at a, 1 at b) of the point on the segment closest to (x,y), or -1 if (x,y) doesn't overlap the segment
+    auto hitParam = [=](double x, double y)
+    {
+        double t = (lenSq > 0 ? ((x - ax)*dx + (y - ay)*dy) / lenSq : 0);
+        t = max(0.0, min(1.0, t));
+        double px = ax + t*dx - x, py = ay + t*dy - y;
+        return (sqrt(px*px + py*py) <= 2*SPRITE_RADIUS ? t : -1.0);
+    };
+    // One query covering the whole segment
+    double cx = (ax + bx) / 2, cy = (ay + by) / 2;
+    double radius = sqrt(lenSq) / 2 + 2*SPRITE_RADIUS;
+    m_pathHits.clear();
+    m_dirt.forEachLiveNear(cx, cy, radius, [&](int pile, int x, int y)
+    {
+        double t = hitParam(x, y);
+        if (t >= 0)
+            m_pathHits.push_back(PathHit{t, pile, nullptr});
+    });
+    m_grid.forEachNear(cx, cy, radius, [&](Actor* b)
+    {
+        PROFILE_COUNT(CANDIDATES_SCANNED, 1);
+        if (b->isDead())
+            return;
+        double t = hitParam(b->getX(), b->getY());
+        if (t >= 0)
+            m_pathHits.push_back(PathHit{t, -1, b});
+    });
+    sort(m_pathHits.begin(), m_pathHits.end(), [](const PathHit& p, const PathHit& q)
+    {
+        if (p.t != q.t)
+            return p.t < q.t;
+        if ((p.actor == nullptr) != (q.actor == nullptr))
+            return p.actor == nullptr; // Dirt first
+        return (p.actor == nullptr ? p.pile < q.pile : p.actor->getSeq() < q.actor->getSeq());
+    });
+    for (const PathHit& h : m_pathHits)
+    {
+        if (h.actor == nullptr)
+        {
+            m_dirt.kill(h.pile); // Dirt dies from any hit
+            return true;
+        }
+        if (h.actor->damage(dmg)) // Attempts to damage current Actor
+            return true;
+    }
+    return false;
+}
+
+// StudentWorld method that moves an actor to its new grid cell after it moves
+void StudentWorld::actorMoved(Actor* a)
+{
+    m_grid.update(a); // Does nothing for actors not in the grid (Socrates)
+    if (gameOptions().autoPlay && a->isBacteria()) // Move its count if it crossed into another rim sector
+    {
+        int sector = rimSector(a->getX(), a->getY());
+        if (sector != static_cast<Bacteria*>(a)->getSector())
+            countInSector(a, sector);
+    }
+}
+
+// StudentWorld method to find which rim sector (x,y) is in
+int StudentWorld::rimSector(int x, int y)
+{
+    int r, theta;
+    cartesianToPolar(dish().centerX(), dish().centerY(), x, y, r, theta); // Angle from the center
+    return (theta + 2) / 5 % N_RIM_SECTORS; // Round to the nearest 5 degrees
+}
+
+// StudentWorld method to move a bacterium's count from the sector it was counted in to sector
+void StudentWorld::countInSector(Actor* a, int sector)
+{
+    Bacteria* b = static_cast<Bacteria*>(a);
+    if (b->getSector() >= 0)
+        m_sectorCounts[b->getSector()]--;
+    if (sector >= 0)
+        m_sectorCounts[sector]++;
+    b->setSector(sector);
+}
+
+// StudentWorld helper that returns the earliest-added actor within radius of (x,y) satisfying pred
+// Neighbor queries used to scan m_actors in order and take the first match, so picking the lowest sequence number gives the same answer
+template<typename Pred>
+Actor* StudentWorld::firstNear(double x, double y, double radius, Pred pred)
+{
+    Actor* first = nullptr;
+    m_grid.forEachNear(x, y, radius, [&](Actor* b)
+    {
+        PROFILE_COUNT(CANDIDATES_SCANNED, 1);
+        if ((first == nullptr || b->getSeq() < first->getSeq()) && pred(b))
+            first = b;
+    });
+    return first;
 }
 
 // StudentWorld method to damage a nearby overlapping Actor
 bool StudentWorld::damageNearbyActor(Actor* a, int dmg)
 {
-    // Loop through whole actor vector using iterator
-    auto it = m_actors.begin();
-    while (it != m_actors.end())
+    PROFILE_SCOPE("StudentWorld::damageNearbyActor");
+    PROFILE_COUNT(QUERIES, 1);
+    // Dirt is always added before any other actor that can be damaged, so an overlapping pile of dirt is always hit first
+    if (m_dirt.damageNear(a->getX(), a->getY(), 2*SPRITE_RADIUS))
+        return true;
+    // Collect live overlapping actors from the grid
+    m_nearby.clear();
+    m_grid.forEachNear(a->getX(), a->getY(), 2*SPRITE_RADIUS, [&](Actor* b)
+    {
+        PROFILE_COUNT(CANDIDATES_SCANNED, 1);
+        if (!b->isDead() && overlaps(a, b)) // Check if candidate and passed in Actor overlap, and if candidate is alive
+            m_nearby.push_back(b);
+    });
+    // Try them in the order they were added to the world (same order as a scan of m_actors)
+    sort(m_nearby.begin(), m_nearby.end(), [](Actor* p, Actor* q) {return p->getSeq() < q->getSeq();});
+    for (Actor* b : m_nearby)
     {
-        if (!(*it)->isDead() && overlaps(a, (*it))) // Check if current Actor in vector and passed in Actor overlap, and if current is alive
+        if (b->damage(dmg)) // Attempts to damage current Actor
+            return true; // Return true if damage succeeds
+    }
+    return false; // Return false if no overlapping actor or overlapping actors can't be damaged
+}
+
+// StudentWorld method to gather every live actor and pile of dirt within radius of (x,y) for later damageInArea calls
+// Lets a ring of flames do one neighbor query per tick instead of one per flame
+void StudentWorld::beginAreaDamage(double x, double y, double radius)
+{
+    PROFILE_SCOPE("StudentWorld::beginAreaDamage");
+    PROFILE_COUNT(QUERIES, 1);
+    m_areaX = x;
+    m_areaY = y;
+    m_area.clear();
+    m_dirt.forEachLiveNear(x, y, radius, [&](int pile, int px, int py)
+    {
+        m_area.push_back(AreaCandidate{hypot(px - x, py - y), atan2(py - y, px - x), pile, px, py, nullptr});
+    });
+    sort(m_area.begin(), m_area.end(), [](const AreaCandidate& p, const AreaCandidate& q) {return p.pile < q.pile;});
+    size_t nPiles = m_area.size();
+    m_grid.forEachNear(x, y, radius, [&](Actor* b)
+    {
+        PROFILE_COUNT(CANDIDATES_SCANNED, 1);
+        if (!b->isDead())
+            m_area.push_back(AreaCandidate{hypot(b->getX() - x, b->getY() - y), atan2(b->getY() - y, b->getX() - x), -1, 0, 0, b});
+    });
+    sort(m_area.begin() + nPiles, m_area.end(), [](const AreaCandidate& p, const AreaCandidate& q) {return p.actor->getSeq() < q.actor->getSeq();});
+}
+
+// StudentWorld method to damage what damageNearbyActor would damage for a projectile at (x,y), searching only the gathered area
+// Candidates are first pruned by distance and angle from the area center (conservatively), then checked exactly as damageNearbyActor does
+bool StudentWorld::damageInArea(double x, double y, int dmg)
+{
+    PROFILE_COUNT(QUERIES, 1);
+    const double EPSILON = 1e-6; // Slack so pruning never rejects a real overlap
+    double dist = hypot(x - m_areaX, y - m_areaY); // Point's distance from the center
+    double angle = atan2(y - m_areaY, x - m_areaX); // Point's angle from the center
+    // Anything within 2*SPRITE_RADIUS of the point lies within this angle of it, as seen from the center (unless the center itself is that close)
+    double maxAngle = (dist > 2*SPRITE_RADIUS + EPSILON ? asin(2*SPRITE_RADIUS / dist) + EPSILON : 4);
+    auto mightOverlap = [&](const AreaCandidate& c)
+    {
+        if (abs(c.dist - dist) > 2*SPRITE_RADIUS + EPSILON) // Outside the ring band
+            return false;
+        double dAngle = abs(c.angle - angle);
+        return min(dAngle, 2*M_PI - dAngle) <= maxAngle; // Inside the sector
+    };
+    for (const AreaCandidate& c : m_area)
+    {
+        if (!mightOverlap(c))
+            continue;
+        if (c.actor == nullptr) // Dirt comes first, as in damageNearbyActor
+        {
+            if (m_dirt.isAlive(c.pile) && coordsWithin(c.x, c.y, x, y, 2*SPRITE_RADIUS))
+            {
+                m_dirt.kill(c.pile); // Dirt dies from any hit
+                return true;
+            }
+        }
+        else if (!c.actor->isDead() && withinDistance(c.actor, x, y, 2*SPRITE_RADIUS)) // Same overlap test as overlaps()
         {
-            if ((*it)->damage(dmg)) // Attempts to damage current Actor
-                return true; // Return true if damage succeeds
+            if (c.actor->damage(dmg)) // Attempts to damage current Actor
+                return true;
         }
-        it++;
     }
-    return false; // Return false if no overlapping actor or overlapping actors can't be damaged
+    return false;
 }
 
 // StudentWorld method that returns if passed in actor overlaps Socrates
 bool StudentWorld::overlapsPlayer(Actor* a)
 {
+    PROFILE_COUNT(QUERIES, 1);
+    CoordDistance dist;
+    if (m_batch.playerDistance(a, dist)) // Measured by the batched pass (same test as overlaps)
+        return distanceWithin(dist, 2*SPRITE_RADIUS);
     if (overlaps(a, m_player)) // Checks if passed in actor overlaps with Socrates
         return true;
     return false;
@@ -165,64 +539,59 @@ bool StudentWorld::overlapsPlayer(Actor* a)
 // StudentWorld method that deletes overlapping edible
 bool StudentWorld::eatNearbyFood(Actor* a)
 {
-    // Loop through actor vector using iterator
-    auto it = m_actors.begin();
-    while (it != m_actors.end())
-    {
-        if (!(*it)->isDead() && overlaps(a, (*it)) && (*it)->isEdible()) // Check if current Actor and passed in actor overlaps and that current Actor is edible, and if it is alive
-        {
-            (*it)->setDead(); // Kill the edible Actor and return true
-            return true;
-        }
-        it++;
-    }
-    return false;
+    PROFILE_SCOPE("StudentWorld::eatNearbyFood");
+    PROFILE_COUNT(QUERIES, 1);
+    // Find first live edible actor overlapping passed in actor
+    Actor* food;
+    if (!m_batch.foodToEat(a, food)) // Unless the batched pass already found it
+        food = firstNear(a->getX(), a->getY(), 2*SPRITE_RADIUS, [a](Actor* b) {return !b->isDead() && b->isEdible() && overlaps(a, b);});
+    if (food == nullptr)
+        return false;
+    food->setDead(); // Kill the edible Actor and return true
+    return true;
 }
 
 // StudentWorld method that returns whether a passed in actor and specified polar movement is valid (for bacteria movement so it uses mvmt overlap definition)
 bool StudentWorld::validMove(Actor* a, int dir, int dist)
 {
+    PROFILE_SCOPE("StudentWorld::validMove");
+    PROFILE_COUNT(QUERIES, 1);
     int proposeX, proposeY; // Set up temp variables to save cartesian movement coords
     polarToCartesian(a->getX(), a->getY(), dist, dir, proposeX, proposeY); // Convert input polar coords to cartesian coords
     
-    // Loop through all actors in World
-    auto it = m_actors.begin();
-    while (it != m_actors.end())
-    {
-        // Check if current actor will block bacteria and movement overlaps with proposed coords
-        if ((*it)->blocksBacteria() && getDistance((*it), proposeX, proposeY) <= SPRITE_RADIUS)
-            return false;
-        else if (getDistanceFromCenter(proposeX, proposeY) >= VIEW_RADIUS) // Check if proposed coords will go out of dish
-            return false;
-        it++;
-    }
-    return true; // Return true if proposed movement is not blocked
+    if (m_actors.empty()) // Nothing to block (and, as before, no dish check without actors)
+        return true;
+    if (getDistanceFromCenter(proposeX, proposeY) >= dish().radius) // Check if proposed coords will go out of dish
+        return false;
+    // Check if any dirt (the only thing that blocks bacteria) overlaps proposed coords using movement overlap
+    return !m_dirt.blocks(proposeX, proposeY, SPRITE_RADIUS); // Return true if proposed movement is not blocked
 }
 
 // StudentWorld method that returns the angle from an actor to the nearest edible (within specified distance "dist")
 bool StudentWorld::getAngleToNearestFood(Actor* a, int dist, int &angle)
 {
-    // Loop through all actors in World
-    auto it = m_actors.begin();
-    while (it != m_actors.end())
-    {
-        if ((*it)->isEdible() && getDistance(a, (*it)) <= dist) // Check if current Actor is edible and is within input distance
-        {
-            int radius; // Set up dummy variable to be passed into cartesianToPolar (won't be used)
-            // Convert cartesian vector coords from actor to edible to polar coords
-            // Pass angle through reference parameter back to caller
-            cartesianToPolar(a->getX(), a->getY(), (*it)->getX(), (*it)->getY(), radius, angle);
-            return true; // Return true since we found a valid edible
-        }
-        it++;
-    }
-    return false; // Return false if no edible found
+    PROFILE_SCOPE("StudentWorld::getAngleToNearestFood");
+    PROFILE_COUNT(QUERIES, 1);
+    // Find first edible actor within input distance
+    Actor* food;
+    if (!m_batch.foodInRange(a, dist, food)) // Unless the batched pass already found it
+        food = firstNear(a->getX(), a->getY(), dist, [a, dist](Actor* b) {return b->isEdible() && withinDistance(a, b, dist);});
+    if (food == nullptr)
+        return false; // Return false if no edible found
+    int radius; // Set up dummy variable to be passed into cartesianToPolar (won't be used)
+    // Convert cartesian vector coords from actor to edible to polar coords
+    // Pass angle through reference parameter back to caller
+    cartesianToPolar(a->getX(), a->getY(), food->getX(), food->getY(), radius, angle);
+    return true; // Return true since we found a valid edible
 }
 
 // StudentWorld method that returns the angle from an Actor to Socrates within specified distance dist
 bool StudentWorld::getAngleToSocrates(Actor* a, int dist, int &angle)
 {
-    if (getDistance(a, m_player) <= dist) // Check if passed Actor is within dist distance from Socrates
+    PROFILE_COUNT(QUERIES, 1);
+    CoordDistance measured;
+    bool within = m_batch.playerDistance(a, measured) ? distanceWithin(measured, dist) : withinDistance(a, m_player, dist); // Measured by the batched pass, or measure now
+    if (within) // Check if passed Actor is within dist distance from Socrates
     {
         int radius; // Set up dummy variable to be passed into cartesianToPolar (won't be used)
         // Convert cartesian vector coords from actor to Socrates to polar coords
@@ -233,6 +602,61 @@ bool StudentWorld::getAngleToSocrates(Actor* a, int dist, int &angle)
     return false; // Return false if Socrates not found in input bound
 }
 
+// StudentWorld method to schedule a dormant actor's next turn
+void StudentWorld::wakeAt(Actor* a, unsigned long tick)
+{
+    if (a->getTimer() >= 0) // Replaces any earlier wake-up
+        m_timers.cancel(a->getTimer());
+    a->setTimer(m_timers.schedule(a, tick));
+}
+
+// StudentWorld method to wake dormant actors that overlap Socrates (same test as overlapsPlayer)
+void StudentWorld::wakeTouchingPlayer()
+{
+    m_grid.forEachNear(m_player->getX(), m_player->getY(), 2*SPRITE_RADIUS, [this](Actor* b)
+    {
+        if (b->isDormant() && b->wakesOnPlayerContact() && !b->isDead() && overlaps(b, m_player))
+            m_woken.push_back(b);
+    });
+}
+
+// StudentWorld method to get Socrates' next command
+bool StudentWorld::getPlayerCommand(int &ch)
+{
+    if (m_controller != nullptr) // Auto player decides from world state
+        return m_controller->getCommand(ch);
+    return getKey(ch); // Otherwise use keystroke
+}
+
+// StudentWorld method to count live bacteria within radius of (x,y), up to limit
+int StudentWorld::countBacteriaNear(double x, double y, double radius, int limit)
+{
+    PROFILE_COUNT(QUERIES, 1);
+    int count = 0;
+    m_grid.forEachNear(x, y, radius, [&](Actor* b)
+    {
+        if (count < limit && !b->isDead() && b->isBacteria() && withinDistance(b, x, y, radius))
+            count++;
+    });
+    return count;
+}
+
+// StudentWorld method to check if a spray fired from an actor would pass over a live bacterium (same path as Spray)
+bool StudentWorld::bacteriaInLane(Actor* from, Direction dir, int dist)
+{
+    PROFILE_COUNT(QUERIES, 1);
+    for (int d = 2*SPRITE_RADIUS; d <= dist + 2*SPRITE_RADIUS; d += 2*SPRITE_RADIUS) // Each point the spray occupies
+    {
+        int x, y;
+        polarToCartesian(from->getX(), from->getY(), d, dir, x, y);
+        if (getDistanceFromCenter(x, y) > dish().radius) // Lane leaves the dish
+            return false;
+        if (firstNear(x, y, 2*SPRITE_RADIUS, [x, y](Actor* b) {return !b->isDead() && b->isBacteria() && overlaps(b, x, y);}) != nullptr)
+            return true;
+    }
+    return false;
+}
+
 // StudentWorld method to set Socrates HP to input hp
 void StudentWorld::restorePlayerHP(int hp)
 {
@@ -255,17 +679,18 @@ void StudentWorld::damagePlayer(int hp)
 // StudentWorld method to get unique coords in the petri dish that doesn't overlap the first nActors in the World's Actor vector
 void StudentWorld::genUniqueCoords(int &x, int &y, int nActors)
 {
+    PROFILE_SCOPE("StudentWorld::genUniqueCoords");
     int tempX, tempY; // Declare temp x, y vars
     bool overlapping = false; // Declare boolean to check if proposed coords overlap with existing actor
+    unsigned long lastSeq = (nActors > 0 ? m_actors[nActors-1]->getSeq() : 0); // Only the first nActors count (actors are in sequence order)
     do
     {
+        tempX = randInt(0, dish().width); // Get random x coord
+        tempY = randInt(0, dish().height); // Get random y coord
         overlapping = false; // Reset overlapping tracker to false at each attempt
-        tempX = randInt(0, VIEW_WIDTH); // Get random x coord
-        tempY = randInt(0, VIEW_HEIGHT); // Get random y coord
-        for (int i = 0; i < nActors; i++) // Check requested actors (first nActors) for overlap
-            if (overlaps(m_actors[i], tempX, tempY))
-                overlapping = true;
-    } while (getDistanceFromCenter(tempX, tempY) > 120 || overlapping); // Generate coords until it is within radius and not overlapping with any of the first nActors
+        if (nActors > 0 && getDistanceFromCenter(tempX, tempY) <= dish().spawnRadius) // Only check overlap for coords inside the spawn radius
+            overlapping = firstNear(tempX, tempY, 2*SPRITE_RADIUS, [lastSeq, tempX, tempY](Actor* b) {return b->getSeq() <= lastSeq && overlaps(b, tempX, tempY);}) != nullptr;
+    } while (getDistanceFromCenter(tempX, tempY) > dish().spawnRadius || overlapping); // Generate coords until it is within radius and not overlapping with any of the first nActors
     // After getting a unique coord, pass the coords to the reference params
     x = tempX;
     y = tempY;
@@ -274,23 +699,42 @@ void StudentWorld::genUniqueCoords(int &x, int &y, int nActors)
 // StudentWorld method to randomly add goodies at each tick
 void StudentWorld::addItems()
 {
+    PROFILE_SCOPE("StudentWorld::addItems");
     int x, y; // Declare vars to store generated coords for goodies
     // Add Fungus
     int chanceFungus = max(510 - getLevel() * 10, 200); // Get chanceFungus chance from spec
-    if (randInt(0, chanceFungus-1) == 0) // If chance succeeds
+    bool addFungus; // Whether the chance comes up this tick
+    if (gameOptions().sampledEvents) // Count down to the drawn tick, then draw the next one
+    {
+        addFungus = (--m_ticksToFungus == 0);
+        if (addFungus)
+            m_ticksToFungus = randTicksUntil(chanceFungus);
+    }
+    else
+        addFungus = (randInt(0, chanceFungus-1) == 0);
+    if (addFungus) // If chance succeeds
     {
         // Add fungus
         int randTheta = randInt(0, 359); // Get random direction
-        polarToCartesian(VIEW_WIDTH/2, VIEW_HEIGHT/2, VIEW_RADIUS, randTheta, x, y); // Convert direction to cartesian coords along edge of petri dish
+        polarToCartesian(dish().centerX(), dish().centerY(), dish().radius, randTheta, x, y); // Convert direction to cartesian coords along edge of petri dish
         addActor(new Fungus(x, y, this)); // Add fungus to World
     }
     // Add Goodies
     int chanceGoodie = max(510 - getLevel() * 10, 250);
-    if (randInt(0, chanceGoodie-1) == 0)
+    bool addGoodie; // Same as for fungus
+    if (gameOptions().sampledEvents)
+    {
+        addGoodie = (--m_ticksToGoodie == 0);
+        if (addGoodie)
+            m_ticksToGoodie = randTicksUntil(chanceGoodie);
+    }
+    else
+        addGoodie = (randInt(0, chanceGoodie-1) == 0);
+    if (addGoodie)
     {
         // Add goodie
         int randTheta = randInt(0, 359); // Get random direction
-        polarToCartesian(VIEW_WIDTH/2, VIEW_HEIGHT/2, VIEW_RADIUS, randTheta, x, y); // Convert direction to cartesian coords along edge of petri dish
+        polarToCartesian(dish().centerX(), dish().centerY(), dish().radius, randTheta, x, y); // Convert direction to cartesian coords along edge of petri dish
         int goodieType = randInt(0, 9); // Generate random int 0-9 (each int has a .1 chance)
         if (goodieType < 6) // .6 chance of RestoreHealthGoodie (ints 0-5)
             addActor(new RestoreHealthGoodie(x, y, this));
@@ -304,48 +748,46 @@ void StudentWorld::addItems()
 // StudentWorld method to delete all dead actors in world
 void StudentWorld::deleteDead()
 {
-    // Loop through whole Actor vector using iterator
-    auto it = m_actors.begin();
-    while (it != m_actors.end())
+    PROFILE_SCOPE("StudentWorld::deleteDead");
+    m_dirt.sweep(); // Remove dirt hit this tick
+    m_active.erase(remove_if(m_active.begin(), m_active.end(), [](Actor* a) {return a->isDead();}), m_active.end()); // Same order kept
+    // Compact the Actor vector in one pass, keeping live actors in their original order
+    auto kept = m_actors.begin();
+    for (auto it = m_actors.begin(); it != m_actors.end(); it++)
     {
         if ((*it)->isDead()) // Check if current actor is dead
         {
+            m_grid.remove(*it); // Remove from spatial index
+            if ((*it)->getTimer() >= 0) // Forget its pending wake-up
+                m_timers.cancel((*it)->getTimer());
+            if ((*it)->preventsLevelCompletion()) // Update level completion count
+                m_nLevelBlockers--;
+            m_metrics.actors[(*it)->getImageID()]--; // Uncount actor by type
+            if (gameOptions().autoPlay && (*it)->isBacteria()) // Uncount it from its rim sector
+                countInSector(*it, -1);
+            m_ledger.remove(*it); // Credit its memory back
             delete (*it); // Deallocate actor
-            m_nActors--; // Decrement actor counter
-            it = m_actors.erase(it); // Erase actor from Vector
+            PROFILE_COUNT(ACTORS_DESTROYED, 1);
         }
-        else // If not dead move on to next actor
-            it++;
+        else // If not dead keep it
+            *kept++ = *it;
     }
+    m_actors.erase(kept, m_actors.end()); // Erase leftover slots from Vector
 }
 
-// StudentWorld method to update game status text using an ostringstream
+// StudentWorld method to update game status text, reformatting only when a value on it changed
 void StudentWorld::updateStatusText()
 {
-    ostringstream oss; // Declare oss
-    oss.fill('0'); // Set fill to 0
-    oss << "Score: " << setw(6) << getScore() << "  "; // Output score
-    oss << "Level: " << getLevel() << "  "; // Output level
-    oss << "Lives: " << getLives() << "  "; // Output lives
-    oss << "Health: " << m_player->getHP() << "  "; // Output health
-    oss << "Sprays: " << m_player->getSprays() << "  "; // Output sprays
-    oss << "Flames: " << m_player->getFlames() << "  "; // Output flames
-    setGameStatText(oss.str()); // Pass the full string to the GameWorld's stat displayer
+    PROFILE_SCOPE("StudentWorld::updateStatusText");
+    if (m_statusLine.update(getScore(), getLevel(), getLives(), m_player->getHP(), m_player->getSprays(), m_player->getFlames()))
+        setGameStatTextBuffer(m_statusLine.c_str()); // Hand the world-owned buffer to the GameWorld's stat displayer (no copy)
 }
 
 // StudentWorld method to check if level is over
 bool StudentWorld::isLevelOver()
 {
-    bool isOver = true; // Declare bool to record if level is over (start with true)
-    // Loop through all actors in world
-    auto it = m_actors.begin();
-    while (it != m_actors.end())
-    {
-        if ((*it)->preventsLevelCompletion()) // Check if current actor prevents level completion
-            isOver = false; // Set bool to false because level is not over
-        it++;
-    }
-    return isOver; // Return if level is over (false if any actor prevents completion)
+    // Level is over once no actor in the world (live or not yet deleted) prevents completion
+    return m_nLevelBlockers == 0;
 }
 
 ////////////
@@ -366,11 +808,23 @@ double getDistance(Actor* a, int x, int y)
     return abs(sqrt(pow((a->getX() - x), 2.0) +  pow((a->getY() - y), 2.0)));
 }
 
+// Returns if two actors are within dist of each other (same as getDistance(a, b) <= dist, but without a square root in fixed point)
+bool withinDistance(Actor* a, Actor* b, double dist)
+{
+    return coordsWithin(a->getCoordX(), a->getCoordY(), b->getCoordX(), b->getCoordY(), dist);
+}
+
+// Returns if an actor is within dist of xy coords
+bool withinDistance(Actor* a, Coord x, Coord y, double dist)
+{
+    return coordsWithin(a->getCoordX(), a->getCoordY(), x, y, dist);
+}
+
 // Returns distance from center to xy coords
 double getDistanceFromCenter(int x, int y)
 {
     // Uses pythagorean theorem
-    return abs(sqrt(pow((x - VIEW_WIDTH/2), 2.0) +  pow((y - VIEW_HEIGHT/2), 2.0)));
+    return abs(sqrt(pow((x - dish().centerX()), 2.0) +  pow((y - dish().centerY()), 2.0)));
 }
 
 // Converts input polar coords from origin oX,oY to cartesian coords x,y
@@ -401,7 +855,7 @@ void cartesianToPolar(int oX, int oY, int x, int y, int &r, int &theta)
 // Returns if two actors overlap
 bool overlaps(Actor* a, Actor* b)
 {
-    if (getDistance(a, b) <= 2*SPRITE_RADIUS) // Check if distance is overlap
+    if (withinDistance(a, b, 2*SPRITE_RADIUS)) // Check if distance is overlap
         return true;
     return false;
 }
@@ -409,7 +863,7 @@ bool overlaps(Actor* a, Actor* b)
 // Returns if an actor and a coord xy overlap
 bool overlaps(Actor* a, int x, int y)
 {
-    if (getDistance(a, x, y) <= 2*SPRITE_RADIUS) // Check if distance is overlap
+    if (withinDistance(a, x, y, 2*SPRITE_RADIUS)) // Check if distance is overlap
         return true;
     return false;
 }
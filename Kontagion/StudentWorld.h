@@ -2,6 +2,15 @@
 #define STUDENTWORLD_H_
 
 #include "GameWorld.h"
+#include "StatusLine.h"
+#include "ActorGrid.h"
+#include "DirtLayer.h"
+#include "ProjectileSystem.h"
+#include "AutoPlayer.h"
+#include "TimerWheel.h"
+#include "MetricsExporter.h"
+#include "ActorLedger.h"
+#include "BacteriaBatch.h"
 #include <string>
 
 #include <vector>
@@ -20,6 +29,8 @@ double getDistanceFromCenter(int x, int y); // Get Euclidian distance from cente
 double getDistanceFromCenter(Actor* a); // Overload for distance from center to an actor
 void polarToCartesian(int oX, int oY, int r, int theta, int &x, int &y); // Convert polar to cartesian
 void cartesianToPolar(int oX, int oY, int x, int y, int &r, int &theta); // Convert cartesian to polar
+bool withinDistance(Actor* a, Actor* b, double dist); // Checks if two actors are no more than dist apart (exact in fixed point too)
+bool withinDistance(Actor* a, Coord x, Coord y, double dist); // Overload for actor and point (x,y)
 bool overlaps(Actor* a, Actor* b); // Checks if two actors overlap
 bool overlaps(Actor* a, int x, int y); // Overload for instances to check between Actor and point (x,y)
 
@@ -35,9 +46,14 @@ public:
     virtual int init();
     virtual int move();
     virtual void cleanUp();
+    virtual void hashState(StateHash& hash); // Adds hit points and Socrates' charges to a golden trace hash
     // Member functions
     void addActor(Actor* a); // Add an actor to world
+    void addProjectile(int imageID, int x, int y, Direction dir, int maxDist, int dmg); // Launch a swept projectile (GameOptions::sweptProjectiles)
+    void actorMoved(Actor* a); // Called by actors after they move so the grid stays current
     bool damageNearbyActor(Actor* a, int dmg); // Damage nearby overlapping actor that can be damaged
+    void beginAreaDamage(double x, double y, double radius); // Gather everything within radius of (x,y) for damageInArea calls
+    bool damageInArea(double x, double y, int dmg); // damageNearbyActor for a point (x,y), using only what beginAreaDamage gathered
     bool overlapsPlayer(Actor* a); // Check if actor overlaps Socrates
     bool eatNearbyFood(Actor* a); // Removes nearest overlapping edible actor
     bool validMove(Actor* a, int dir, int dist); // Checks if passed actor and dir/dist is a valid move for bacteria
@@ -46,20 +62,64 @@ public:
     void restorePlayerHP(int hp); // Sets Socrates hp to new value
     void addPlayerFlames(int flames); // adds flames to Socrates
     void damagePlayer(int hp); // Subtracts hp from socrates.
+    bool getPlayerCommand(int &ch); // Gets Socrates' next command from the keyboard or the auto player
+    unsigned long currentTick() const {return m_tick;} // Number of the current tick (counts up across levels)
+    void wakeAt(Actor* a, unsigned long tick); // Has a dormant actor act on tick (in its usual turn)
+    int countBacteriaNear(double x, double y, double radius, int limit); // Counts live bacteria within radius of (x,y), stopping at limit
+    bool bacteriaInLane(Actor* from, Direction dir, int dist); // Checks if a spray fired from actor in dir would pass a live bacterium within dist
+    static const int N_RIM_SECTORS = 72; // Sectors around the dish center, 5 degrees each (one per Socrates rotation step)
+    static int rimSector(int x, int y); // Sector holding (x,y)
+    int bacteriaInSector(int sector) const {return m_sectorCounts[sector];} // Live bacteria in sector (kept only with GameOptions::autoPlay)
+    const ActorLedger& memory() const {return m_ledger;} // Current and peak actor memory by type (peaks since the last cleanUp)
     // Destructor
     ~StudentWorld();
 
 private:
     // Data Members
     Socrates* m_player; // Pointer to Socrates player
+    PlayerController* m_controller; // Plays Socrates instead of the keyboard (nullptr unless GameOptions::autoPlay)
     std::vector<Actor*> m_actors; // Vector of pointers to Actors in world
-    int m_nActors; // Tracks number of actors in vector
+    size_t m_peakActors; // Most actors m_actors has held at once (in any level)
+    std::vector<Actor*> m_active; // Actors that act every tick (all but dormant ones), in the same order as m_actors
+    TimerWheel m_timers; // Scheduled wake-ups of dormant actors
+    std::vector<Actor*> m_woken; // Dormant actors that act this tick, in sequence order
+    unsigned long m_tick; // Number of the current tick
+    int m_builtLevel; // Level init last built (the framework advances getLevel before cleanUp tears it down)
+    int m_ticksToFungus, m_ticksToGoodie; // Ticks until addItems next adds each (GameOptions::sampledEvents)
+    ActorGrid m_grid; // Spatial index over m_actors for neighbor queries
+    DirtLayer m_dirt; // All dirt in the dish (not in m_actors)
+    ProjectileSystem m_projectiles; // Swept sprays and flames (not in m_actors)
+    struct PathHit {double t; int pile; Actor* actor;}; // Candidate hit along a projectile's path (pile is -1 for actors)
+    std::vector<PathHit> m_pathHits; // Scratch list reused by damageAlongPath
+    struct AreaCandidate {double dist; double angle; int pile; int x, y; Actor* actor;}; // Something gathered by beginAreaDamage, with its polar coords from the area center (pile is -1 for actors)
+    std::vector<AreaCandidate> m_area; // Gathered dirt (by pile) then actors (by sequence)
+    double m_areaX, m_areaY; // Center of the gathered area
+    unsigned long m_nextSeq; // Sequence number for the next actor added
+    int m_nLevelBlockers; // Number of actors in m_actors that prevent level completion
+    std::vector<Actor*> m_nearby; // Scratch list reused by neighbor queries
+    StatusLine m_statusLine; // Preallocated status text, rebuilt only when its values change
+    WorldMetrics m_metrics; // Running totals for GameWorld::getMetrics (actor counts, allocations, tick latencies)
+    ActorLedger m_ledger; // Memory used by Socrates and m_actors, by type
+    BacteriaBatch m_batch; // This tick's batched bacteria measurements (GameOptions::batchedBacteria)
+    int m_sectorCounts[N_RIM_SECTORS]; // Bacteria per rim sector, kept as they're added, move, and are deleted (GameOptions::autoPlay)
     // Member Functions
+    static constexpr size_t SPIKE_HEADROOM = 32; // Room planned beyond a level's own actors for a burst of sprays, flames, and goodies
+    static constexpr size_t MIN_ACTOR_CAPACITY = 64; // Smallest capacity the actor vectors grow to
+    size_t plannedActorCount(int level, double scale) const; // How many actors to reserve room for at the start of a level
+    void reserveActors(size_t n); // Make room for n actors in m_actors and m_active
+    int playTick(); // Plays one tick (move does this, timing it when metrics are on)
+    void publishMetrics(MetricsExporter& metrics); // Fills in the rest of m_metrics and publishes it
     void genUniqueCoords(int &x, int &y, int nActors); // Generates unique valid coords inside petri dish
     void addItems(); // Method to randomly add goodies at each tick
     void deleteDead(); // Clears dead actors and removes them from world
+    void countInSector(Actor* a, int sector); // Moves a bacterium's count to sector (-1 to uncount it)
     void updateStatusText(); // Updates the game status text
     bool isLevelOver(); // Checks if the level is over
+    void moveProjectiles(); // Steps every swept projectile once
+    void wakeTouchingPlayer(); // Adds dormant actors that react to Socrates and overlap him to m_woken
+    bool damageAlongPath(double ax, double ay, double bx, double by, int dmg); // Damage the first damageable thing overlapping segment a-b
+    template<typename Pred>
+    Actor* firstNear(double x, double y, double radius, Pred pred); // Earliest-added actor within radius of (x,y) satisfying pred (nullptr if none)
 };
 
 #endif // STUDENTWORLD_H_
@@ -0,0 +1,138 @@
+#ifndef TIMERWHEEL_H_
+#define TIMERWHEEL_H_
+
+#include <vector>
+
+class Actor;
+
+//////////
+// TimerWheel class declaration
+//////////
+
+// Hierarchical timing wheel that wakes dormant actors on the tick they asked for.
+// Level 0 has a slot per tick for the next 256 ticks, level 1 a slot per 256 ticks for the next 64 of those,
+// level 2 a slot per 16384 ticks for the next 64 of those, and anything further waits in an overflow list.
+// Timers move down a level when the wheel reaches their block, so scheduling, cancelling and firing are O(1) per timer
+// and an idle tick costs one empty slot check.
+
+class TimerWheel
+{
+public:
+    TimerWheel() : m_now(0) {}
+    void reset(unsigned long now); // Drop every timer and set the current tick
+    int schedule(Actor* a, unsigned long tick); // Wake actor on tick (after the current tick), returns the timer's id
+    void cancel(int id); // Forget timer id (it won't fire)
+    template<typename Func>
+    void advance(Func f); // Move to the next tick, calling f(Actor*) for each timer due on it
+
+private:
+    static const int L0_BITS = 8, L1_BITS = 6, L2_BITS = 6; // Slot counts are 256, 64, 64
+    static const unsigned long L0_SIZE = 1UL << L0_BITS, L1_SIZE = 1UL << L1_BITS, L2_SIZE = 1UL << L2_BITS;
+    struct Timer {Actor* actor; unsigned long tick;}; // actor is nullptr once cancelled
+    unsigned long m_now; // Current tick
+    std::vector<Timer> m_timers; // Timers by id
+    std::vector<int> m_freeIds; // Ids of fired or cancelled timers, for reuse
+    std::vector<int> m_level0[L0_SIZE], m_level1[L1_SIZE], m_level2[L2_SIZE], m_overflow; // Timer ids in each slot
+    void place(int id); // Put timer id in the slot for its tick
+    void cascade(std::vector<int>& slot); // Re-place every timer in slot (one level down, now that the wheel has reached it)
+    void release(int id) {m_freeIds.push_back(id);}
+};
+
+//////////
+// TimerWheel inline implementation
+//////////
+
+inline void TimerWheel::reset(unsigned long now)
+{
+    m_now = now;
+    m_timers.clear();
+    m_freeIds.clear();
+    for (std::vector<int>& slot : m_level0)
+        slot.clear();
+    for (std::vector<int>& slot : m_level1)
+        slot.clear();
+    for (std::vector<int>& slot : m_level2)
+        slot.clear();
+    m_overflow.clear();
+}
+
+inline int TimerWheel::schedule(Actor* a, unsigned long tick)
+{
+    if (tick <= m_now) // Too late to wait for, so fire on the next tick
+        tick = m_now + 1;
+    int id;
+    if (!m_freeIds.empty())
+    {
+        id = m_freeIds.back();
+        m_freeIds.pop_back();
+        m_timers[id] = Timer{a, tick};
+    }
+    else
+    {
+        id = static_cast<int>(m_timers.size());
+        m_timers.push_back(Timer{a, tick});
+    }
+    place(id);
+    return id;
+}
+
+inline void TimerWheel::cancel(int id)
+{
+    m_timers[id].actor = nullptr; // Its id is released when the wheel reaches its slot
+}
+
+template<typename Func>
+void TimerWheel::advance(Func f)
+{
+    m_now++;
+    // Bring the next block of each higher level down once the one below has wrapped around (highest first)
+    if ((m_now & (L0_SIZE - 1)) == 0)
+    {
+        if (((m_now >> L0_BITS) & (L1_SIZE - 1)) == 0)
+        {
+            if (((m_now >> (L0_BITS + L1_BITS)) & (L2_SIZE - 1)) == 0)
+                cascade(m_overflow);
+            cascade(m_level2[(m_now >> (L0_BITS + L1_BITS)) & (L2_SIZE - 1)]);
+        }
+        cascade(m_level1[(m_now >> L0_BITS) & (L1_SIZE - 1)]);
+    }
+    // Fire everything due now
+    std::vector<int>& slot = m_level0[m_now & (L0_SIZE - 1)];
+    for (int id : slot)
+    {
+        Actor* a = m_timers[id].actor;
+        release(id);
+        if (a != nullptr)
+            f(a);
+    }
+    slot.clear();
+}
+
+inline void TimerWheel::place(int id)
+{
+    unsigned long tick = m_timers[id].tick;
+    unsigned long delta = tick - m_now;
+    if (delta < L0_SIZE)
+        m_level0[tick & (L0_SIZE - 1)].push_back(id);
+    else if (delta < (L0_SIZE << L1_BITS))
+        m_level1[(tick >> L0_BITS) & (L1_SIZE - 1)].push_back(id);
+    else if (delta < (L0_SIZE << (L1_BITS + L2_BITS)))
+        m_level2[(tick >> (L0_BITS + L1_BITS)) & (L2_SIZE - 1)].push_back(id);
+    else
+        m_overflow.push_back(id);
+}
+
+inline void TimerWheel::cascade(std::vector<int>& slot)
+{
+    std::vector<int> ids;
+    ids.swap(slot); // place may add to this same slot (e.g. overflow timers still far off)
+    for (int id : ids)
+    {
+        if (m_timers[id].actor == nullptr) // Cancelled
+            release(id);
+        else
+            place(id);
+    }
+}
+
+#endif // TIMERWHEEL_H_
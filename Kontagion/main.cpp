@@ -1,7 +1,13 @@
 #include "GameController.h"
+#include "Profiler.h"
+#include "GameWorld.h"
+#include "GoldenTrace.h"
+#include "MetricsExporter.h"
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <memory>
+#include <cstdlib>
 using namespace std;
 
 #ifdef _MSC_VER
@@ -30,6 +36,41 @@ class GameWorld;
 
 GameWorld* createStudentWorld(string assetPath = "");
 
+  // Play ticks ticks with no window (keys come only from --auto-play),
+  // moving on to the next level or life as the game would
+static void fastForwardHeadless(GameWorld* gw, int ticks)
+{
+    int played = 0;
+    double seconds = 0;
+    gw->soundEvents().setEnabled(false);     // no window and no audio
+    gw->init();
+    while (played < ticks)
+    {
+        GameWorld::FastForwardResult result = gw->fastForward(ticks - played);
+        played += result.ticks;
+        seconds += result.seconds;
+        if (result.status == GWSTATUS_PLAYER_DIED)
+        {
+            if (gw->isGameOver())
+                break;
+            gw->cleanUp();
+            gw->init();
+        }
+        else if (result.status == GWSTATUS_FINISHED_LEVEL)
+        {
+            gw->advanceToNextLevel();
+            gw->cleanUp();
+            gw->init();
+        }
+        else if (result.status != GWSTATUS_CONTINUE_GAME)
+            break;
+    }
+    cout << "Fast-forwarded " << played << " ticks to level " << gw->getLevel()
+         << " (score " << gw->getScore() << ", lives " << gw->getLives() << ") at "
+         << static_cast<long>(seconds > 0 ? played / seconds : 0) << " ticks/sec" << endl;
+    gw->cleanUp();
+}
+
 int main(int argc, char* argv[])
 {
     string assetPath = assetDirectory;
@@ -53,6 +94,132 @@ int main(int argc, char* argv[])
         }
     }
 
+      // --threaded runs the simulation on its own thread, separate from drawing
+      // --audio system|null|wav:FILE picks where sound effects go
+      // --profile-trace FILE writes a Chrome trace on exit (needs KONTAGION_PROFILE)
+      // --profile-summary prints a table of the profiled scopes on exit
+      // --dish-radius R plays in a dish of radius R instead of VIEW_RADIUS
+      // --dish-density D scales the number of pits, food, and dirt in a large dish
+      // --swept-projectiles makes sprays and flames hit anything along their path
+      // --flame-bursts makes each flame charge a single ring-shaped actor
+      // --auto-play lets the computer play Socrates (for load testing)
+      // --batched-bacteria measures what every bacterium will ask the world in one pass per tick
+      // --sampled-events draws ticks until the next pit emission or goodie instead of rolling every tick
+      // --memory-report prints actor memory by type at the end of each level
+      // --cached-static-layer draws the dish outline, dirt, and pits from a
+      //     display list that is redrawn only when one of them changes
+      // --bench-draw N times drawing N sprites per frame instead of playing
+      // --seed S makes the game's random choices the same on every run
+      // --golden-record FILE plays --golden-ticks N ticks (default 3000) headlessly
+      //     from --seed S (default 1) and writes a hash of the state after each
+      // --golden-check FILE replays a recorded trace and reports where it differs
+      // --fast-forward N plays N ticks headlessly as fast as possible and reports ticks/sec
+      // --metrics-file FILE rewrites FILE with live metrics (Prometheus text
+      //     format) every --metrics-interval MS milliseconds (default 1000)
+    string profileTraceFile;
+    bool profileSummary = false;
+    int dishRadius = VIEW_RADIUS;
+    double dishDensity = 1.0;
+    string goldenRecordFile;
+    string goldenCheckFile;
+    int goldenTicks = 3000;
+    unsigned int seed = 1;
+    bool seeded = false;
+    int fastForwardTicks = 0;
+    string metricsFile;
+    int metricsInterval = 1000;
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "--threaded")
+            Game().setThreadedSimulation(true);
+        else if (arg == "--audio"  &&  i+1 < argc)
+        {
+            string backend = argv[++i];
+            if (backend == "null")
+                Game().setAudioBackend(AudioEngine::NULL_BACKEND);
+            else if (backend.compare(0, 4, "wav:") == 0)
+                Game().setAudioBackend(AudioEngine::WAV_FILE_BACKEND, backend.substr(4));
+            else
+                Game().setAudioBackend(AudioEngine::SYSTEM_BACKEND);
+        }
+        else if (arg == "--profile-trace"  &&  i+1 < argc)
+            profileTraceFile = argv[++i];
+        else if (arg == "--profile-summary")
+            profileSummary = true;
+        else if (arg == "--dish-radius"  &&  i+1 < argc)
+            dishRadius = atoi(argv[++i]);
+        else if (arg == "--dish-density"  &&  i+1 < argc)
+            dishDensity = atof(argv[++i]);
+        else if (arg == "--swept-projectiles")
+            gameOptions().sweptProjectiles = true;
+        else if (arg == "--flame-bursts")
+            gameOptions().flameBursts = true;
+        else if (arg == "--auto-play")
+            gameOptions().autoPlay = true;
+        else if (arg == "--batched-bacteria")
+            gameOptions().batchedBacteria = true;
+        else if (arg == "--sampled-events")
+            gameOptions().sampledEvents = true;
+        else if (arg == "--memory-report")
+            gameOptions().memoryReport = true;
+        else if (arg == "--cached-static-layer")
+            Game().setStaticLayerCache(true);
+        else if (arg == "--bench-draw"  &&  i+1 < argc)
+            Game().setDrawBenchmark(atoi(argv[++i]));
+        else if (arg == "--seed"  &&  i+1 < argc)
+        {
+            seed = static_cast<unsigned int>(strtoul(argv[++i], nullptr, 10));
+            seeded = true;
+        }
+        else if (arg == "--golden-record"  &&  i+1 < argc)
+            goldenRecordFile = argv[++i];
+        else if (arg == "--golden-check"  &&  i+1 < argc)
+            goldenCheckFile = argv[++i];
+        else if (arg == "--golden-ticks"  &&  i+1 < argc)
+            goldenTicks = atoi(argv[++i]);
+        else if (arg == "--fast-forward"  &&  i+1 < argc)
+            fastForwardTicks = atoi(argv[++i]);
+        else if (arg == "--metrics-file"  &&  i+1 < argc)
+            metricsFile = argv[++i];
+        else if (arg == "--metrics-interval"  &&  i+1 < argc)
+            metricsInterval = atoi(argv[++i]);
+    }
+    if (dishRadius != VIEW_RADIUS  ||  dishDensity != 1.0)
+        setDishRadius(dishRadius, dishDensity);
+    if ((!profileTraceFile.empty()  ||  profileSummary)  &&  !Profiler::enabled())
+        cout << "Profiling was not compiled in; rebuild with KONTAGION_PROFILE defined." << endl;
+
     GameWorld* gw = createStudentWorld(assetPath);
+    if (!goldenRecordFile.empty()  ||  !goldenCheckFile.empty())
+    {
+        int status = goldenRecordFile.empty() ? checkGoldenTrace(gw, goldenCheckFile)
+                                              : recordGoldenTrace(gw, goldenRecordFile, seed, goldenTicks);
+        delete gw;
+        return status;
+    }
+    if (seeded)
+        seedRandom(seed);
+    unique_ptr<MetricsExporter> metrics;
+    if (!metricsFile.empty())
+    {
+        metrics.reset(new MetricsExporter(metricsFile, metricsInterval));
+        gw->setMetrics(metrics.get());
+        metrics->start();
+    }
+    if (fastForwardTicks > 0)
+    {
+        fastForwardHeadless(gw, fastForwardTicks);
+        delete gw;
+        return 0;
+    }
     Game().run(argc, argv, gw, "Kontagion");
+
+    if (!profileTraceFile.empty())
+    {
+        ofstream trace(profileTraceFile);
+        Profiler::writeChromeTrace(trace);
+    }
+    if (profileSummary)
+        Profiler::writeSummary(cout);
 }